@@ -0,0 +1,370 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "aggregate.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#define AGG_MAX_THREADS 64
+#define NAME_SLOTS_USED (AGG_MAX_NAMES * 3 / 4)  // Keep the table at most 3/4 full
+
+int aggInit(Aggregate *agg) {
+    memset(agg, 0, sizeof(*agg));
+    strcpy(agg->others.name, "(other)");
+    agg->players = (PlayerTally *)calloc(AGG_MAX_NAMES, sizeof(PlayerTally));
+    return agg->players != NULL;
+}
+
+void aggFree(Aggregate *agg) {
+    free(agg->players);
+    agg->players = NULL;
+}
+
+static uint64_t nameHash(const char *name) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    while (*name) hash = (hash ^ (unsigned char)*name++) * 0x100000001B3ull;
+    return hash;
+}
+
+// Tally slot for name, created if needed; the "(other)" tally once the table is full
+static PlayerTally *playerSlot(Aggregate *agg, const char *name) {
+    size_t slot = (size_t)(nameHash(name) & (AGG_MAX_NAMES - 1));
+    while (agg->players[slot].name[0] != '\0') {
+        if (strcmp(agg->players[slot].name, name) == 0) return &agg->players[slot];
+        slot = (slot + 1) & (AGG_MAX_NAMES - 1);
+    }
+    if (agg->playerCount >= NAME_SLOTS_USED) return &agg->others;
+    strncpy(agg->players[slot].name, name, ARCHIVE_NAME_MAX - 1);
+    agg->playerCount++;
+    return &agg->players[slot];
+}
+
+static void tallyAdd(ResultTally *tally, const GameRecord *record) {
+    tally->games++;
+    tally->moves += record->moveCount;
+    if (record->winner >= 0) tally->wins[record->winner]++;
+    else tally->draws++;
+}
+
+static void tallyMerge(ResultTally *into, const ResultTally *from) {
+    into->games += from->games;
+    into->draws += from->draws;
+    into->moves += from->moves;
+    for (int i = 0; i < BOARD_MAX_PLAYERS; i++) into->wins[i] += from->wins[i];
+}
+
+void aggAddGame(Aggregate *agg, const GameRecord *record) {
+    tallyAdd(&agg->total, record);
+    tallyAdd(&agg->bySize[record->size], record);
+    if (record->mode >= 1 && record->mode <= 3) tallyAdd(&agg->byMode[record->mode], record);
+
+    if (record->moveCount > 0) {
+        agg->openings[record->size][record->moves[0]]++;
+        if (record->winner == 0) agg->openingWins[record->size][record->moves[0]]++;
+    }
+
+    for (int i = 0; i < record->players; i++) {
+        if (record->names[i] == NULL || record->names[i][0] == '\0') continue;
+        PlayerTally *player = playerSlot(agg, record->names[i]);
+        player->games++;
+        if (record->winner == i) player->wins++;
+        else if (record->winner < 0) player->draws++;
+    }
+}
+
+void aggMerge(Aggregate *into, const Aggregate *from) {
+    tallyMerge(&into->total, &from->total);
+    for (int s = 0; s <= BOARD_MAX_SIZE; s++) {
+        tallyMerge(&into->bySize[s], &from->bySize[s]);
+        for (int c = 0; c < BOARD_MAX_CELLS; c++) {
+            into->openings[s][c] += from->openings[s][c];
+            into->openingWins[s][c] += from->openingWins[s][c];
+        }
+    }
+    for (int m = 0; m < 4; m++) tallyMerge(&into->byMode[m], &from->byMode[m]);
+
+    for (int i = 0; i < AGG_MAX_NAMES; i++) {
+        const PlayerTally *player = &from->players[i];
+        if (player->name[0] == '\0') continue;
+        PlayerTally *slot = playerSlot(into, player->name);
+        slot->games += player->games;
+        slot->wins += player->wins;
+        slot->draws += player->draws;
+    }
+    into->others.games += from->others.games;
+    into->others.wins += from->others.wins;
+    into->others.draws += from->others.draws;
+    into->malformed += from->malformed;
+    into->bytes += from->bytes;
+    into->files += from->files;
+}
+
+void aggScan(Aggregate *agg, const Archive *archive, size_t begin, size_t end) {
+    const unsigned char *data = archive->data;
+    size_t size = archive->size;
+    GameRecord record;
+    size_t pos = begin;
+
+    if (archive->format == ARCHIVE_BINARY) {
+        while (pos < end) {
+            long used = recordDecode(data + pos, size - pos, archive->version, &record);
+            if (used <= 0) {
+                if (used < 0) agg->malformed++;  // Nothing after a corrupt record can be trusted
+                break;
+            }
+            aggAddGame(agg, &record);
+            pos += (size_t)used;
+        }
+    } else {
+        char names[BOARD_MAX_PLAYERS][ARCHIVE_NAME_MAX];
+        while (pos < end) {
+            size_t next = archiveTextGameEnd(data, size, pos);
+            if (next == 0) break;  // Unfinished game at the end of the file
+            if (archiveParseText(data + pos, next - pos, &record, names)) aggAddGame(agg, &record);
+            else agg->malformed++;
+            pos = next;
+        }
+    }
+    agg->bytes += (long long)(end - begin);
+}
+
+// First game start at or after offset in a text file (size if there is none)
+static size_t textBoundary(const Archive *archive, size_t offset) {
+    const unsigned char *data = archive->data;
+    if (offset == 0) return 0;
+    if (data[offset - 1] != '\n') {
+        const unsigned char *eol = (const unsigned char *)memchr(data + offset, '\n', archive->size - offset);
+        if (eol == NULL) return archive->size;
+        offset = (size_t)(eol - data) + 1;
+    }
+    size_t end = archiveTextGameEnd(data, archive->size, offset);
+    return end ? end : archive->size;
+}
+
+typedef struct {
+    Aggregate agg;
+    const Archive *archive;
+    size_t begin, end;
+} ScanJob;
+
+static void *scanThread(void *arg) {
+    ScanJob *job = (ScanJob *)arg;
+    aggScan(&job->agg, job->archive, job->begin, job->end);
+    return NULL;
+}
+
+int aggFile(Aggregate *agg, const char *path, int threads) {
+    Archive archive;
+    if (!archiveMap(&archive, path)) return 0;
+    size_t first = archiveFirstGame(&archive);
+#ifndef _WIN32
+    if (archive.size > 0) posix_madvise(archive.dataMap, archive.size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    // Binary records carry no marker to resynchronise on, and a single pass
+    // over them is already memory-bound - only text is split
+    if (threads > AGG_MAX_THREADS) threads = AGG_MAX_THREADS;
+    if (archive.format == ARCHIVE_BINARY || threads < 2 || archive.size < ((size_t)1 << 20)) {
+        aggScan(agg, &archive, first, archive.size);
+        agg->files++;
+        archiveClose(&archive);
+        return 1;
+    }
+
+    ScanJob *jobs = (ScanJob *)calloc((size_t)threads, sizeof(ScanJob));
+    if (jobs == NULL) {
+        archiveClose(&archive);
+        return 0;
+    }
+    int ready = 0;
+    for (; ready < threads; ready++) {
+        if (!aggInit(&jobs[ready].agg)) break;
+    }
+
+    pthread_t ids[AGG_MAX_THREADS];
+    int started = 0;
+    size_t begin = first;
+    for (int t = 0; t < ready; t++) {
+        // Cut at the first game boundary after each equal share of the file
+        size_t end = (t == ready - 1) ? archive.size : textBoundary(&archive, archive.size / ready * (t + 1));
+        if (end < begin) end = begin;
+        jobs[t].archive = &archive;
+        jobs[t].begin = begin;
+        jobs[t].end = end;
+        begin = end;
+        if (t > 0 && pthread_create(&ids[started], NULL, scanThread, &jobs[t]) == 0) {
+            started++;
+        } else if (t > 0) {
+            scanThread(&jobs[t]);
+        }
+    }
+    if (ready > 0) scanThread(&jobs[0]);
+    for (int t = 0; t < started; t++) pthread_join(ids[t], NULL);
+
+    for (int t = 0; t < ready; t++) {
+        aggMerge(agg, &jobs[t].agg);
+        aggFree(&jobs[t].agg);
+    }
+    free(jobs);
+    agg->files++;
+    archiveClose(&archive);
+    return ready > 0;
+}
+
+static double percent(long long part, long long whole) {
+    return whole > 0 ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static void printTallyRow(FILE *out, const char *label, const ResultTally *tally) {
+    fprintf(out, "  %-10s %12lld %7.1f%% %7.1f%% %7.1f%% %7.1f%% %9.2f\n", label, tally->games,
+            percent(tally->wins[0], tally->games), percent(tally->wins[1], tally->games),
+            percent(tally->wins[2], tally->games), percent(tally->draws, tally->games),
+            tally->games ? (double)tally->moves / (double)tally->games : 0.0);
+}
+
+// Opening cell with the best first-mover win rate among cells opened in at
+// least 1% of the games on that size; -1 if no game was played on it
+static int bestOpening(const Aggregate *agg, int size) {
+    long long minimum = agg->bySize[size].games / 100;
+    int best = -1;
+    double bestRate = -1;
+    for (int c = 0; c < size * size; c++) {
+        long long games = agg->openings[size][c];
+        if (games == 0 || games < minimum) continue;
+        double rate = (double)agg->openingWins[size][c] / (double)games;
+        if (rate > bestRate) {
+            bestRate = rate;
+            best = c;
+        }
+    }
+    return best;
+}
+
+static int comparePlayers(const void *a, const void *b) {
+    const PlayerTally *x = *(const PlayerTally *const *)a, *y = *(const PlayerTally *const *)b;
+    if (x->games != y->games) return (x->games < y->games) ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+// Used player slots, most games first; returns how many (caller frees *list)
+static int sortedPlayers(const Aggregate *agg, const PlayerTally ***list) {
+    *list = (const PlayerTally **)malloc((size_t)(agg->playerCount + 1) * sizeof(PlayerTally *));
+    if (*list == NULL) return 0;
+    int count = 0;
+    for (int i = 0; i < AGG_MAX_NAMES; i++) {
+        if (agg->players[i].name[0] != '\0') (*list)[count++] = &agg->players[i];
+    }
+    if (agg->others.games > 0) (*list)[count++] = &agg->others;
+    qsort(*list, (size_t)count, sizeof(PlayerTally *), comparePlayers);
+    return count;
+}
+
+void aggPrintTable(FILE *out, const Aggregate *agg) {
+    const ResultTally *total = &agg->total;
+    char label[32];
+
+    fprintf(out, "Games: %lld from %d file(s), %.1f MB", total->games, agg->files, (double)agg->bytes / 1e6);
+    if (agg->malformed > 0) fprintf(out, " (%lld malformed, skipped)", agg->malformed);
+    fprintf(out, "\n\n  %-10s %12s %8s %8s %8s %8s %9s\n", "", "games", "X wins", "O wins", "Z wins", "draws", "avg moves");
+    printTallyRow(out, "All", total);
+    for (int s = BOARD_MIN_SIZE; s <= BOARD_MAX_SIZE; s++) {
+        if (agg->bySize[s].games == 0) continue;
+        snprintf(label, sizeof(label), "%d x %d", s, s);
+        printTallyRow(out, label, &agg->bySize[s]);
+    }
+    for (int m = 1; m <= 3; m++) {
+        if (agg->byMode[m].games == 0) continue;
+        snprintf(label, sizeof(label), "Mode %d", m);
+        printTallyRow(out, label, &agg->byMode[m]);
+    }
+
+    fprintf(out, "\nFirst-move advantage: X (moves first) wins %.1f%%, O wins %.1f%% (%+.1f points)\n",
+            percent(total->wins[0], total->games), percent(total->wins[1], total->games),
+            percent(total->wins[0], total->games) - percent(total->wins[1], total->games));
+    for (int s = BOARD_MIN_SIZE; s <= BOARD_MAX_SIZE; s++) {
+        int best = bestOpening(agg, s);
+        if (best < 0) continue;
+        fprintf(out, "  %d x %d: best opening row %d, col %d - first mover wins %.1f%% of %lld games\n", s, s,
+                best / s + 1, best % s + 1, percent(agg->openingWins[s][best], agg->openings[s][best]),
+                agg->openings[s][best]);
+    }
+
+    const PlayerTally **players;
+    int count = sortedPlayers(agg, &players);
+    if (count > 0) {
+        fprintf(out, "\n  %-20s %10s %8s %8s\n", "Player", "games", "wins", "draws");
+        for (int i = 0; i < count && i < 20; i++) {
+            fprintf(out, "  %-20s %10lld %7.1f%% %7.1f%%\n", players[i]->name, players[i]->games,
+                    percent(players[i]->wins, players[i]->games), percent(players[i]->draws, players[i]->games));
+        }
+        if (count > 20) fprintf(out, "  ... %d more players in the JSON output\n", count - 20);
+    }
+    free(players);
+}
+
+static void printJsonString(FILE *out, const char *text) {
+    fputc('"', out);
+    for (; *text; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+        else if (c < 0x20) fprintf(out, "\\u%04x", c);
+        else fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+static void printJsonTally(FILE *out, const ResultTally *tally) {
+    fprintf(out, "{\"games\": %lld, \"winsX\": %lld, \"winsO\": %lld, \"winsZ\": %lld, \"draws\": %lld, "
+            "\"averageMoves\": %.3f}", tally->games, tally->wins[0], tally->wins[1], tally->wins[2], tally->draws,
+            tally->games ? (double)tally->moves / (double)tally->games : 0.0);
+}
+
+void aggPrintJson(FILE *out, const Aggregate *agg) {
+    fprintf(out, "{\n  \"files\": %d,\n  \"bytes\": %lld,\n  \"malformed\": %lld,\n  \"total\": ",
+            agg->files, agg->bytes, agg->malformed);
+    printJsonTally(out, &agg->total);
+
+    const char *separator = "";
+    fprintf(out, ",\n  \"bySize\": {");
+    for (int s = BOARD_MIN_SIZE; s <= BOARD_MAX_SIZE; s++) {
+        if (agg->bySize[s].games == 0) continue;
+        fprintf(out, "%s\n    \"%d\": ", separator, s);
+        printJsonTally(out, &agg->bySize[s]);
+        separator = ",";
+    }
+    separator = "";
+    fprintf(out, "\n  },\n  \"byMode\": {");
+    for (int m = 1; m <= 3; m++) {
+        if (agg->byMode[m].games == 0) continue;
+        fprintf(out, "%s\n    \"%d\": ", separator, m);
+        printJsonTally(out, &agg->byMode[m]);
+        separator = ",";
+    }
+
+    // Per size: games opened on each cell (row-major) and how many the first mover won
+    separator = "";
+    fprintf(out, "\n  },\n  \"openings\": {");
+    for (int s = BOARD_MIN_SIZE; s <= BOARD_MAX_SIZE; s++) {
+        if (agg->bySize[s].games == 0) continue;
+        fprintf(out, "%s\n    \"%d\": {\"games\": [", separator, s);
+        for (int c = 0; c < s * s; c++) fprintf(out, "%s%lld", c ? ", " : "", agg->openings[s][c]);
+        fprintf(out, "], \"firstMoverWins\": [");
+        for (int c = 0; c < s * s; c++) fprintf(out, "%s%lld", c ? ", " : "", agg->openingWins[s][c]);
+        fprintf(out, "]}");
+        separator = ",";
+    }
+
+    const PlayerTally **players;
+    int count = sortedPlayers(agg, &players);
+    fprintf(out, "\n  },\n  \"players\": [");
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "%s\n    {\"name\": ", i ? "," : "");
+        printJsonString(out, players[i]->name);
+        fprintf(out, ", \"games\": %lld, \"wins\": %lld, \"draws\": %lld}",
+                players[i]->games, players[i]->wins, players[i]->draws);
+    }
+    fprintf(out, "%s]\n}\n", count ? "\n  " : "");
+    free(players);
+}
@@ -0,0 +1,66 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <stdio.h>
+#include "archive.h"
+
+// Streaming statistics over game results: one pass over mapped result files
+// (text from saveGameResult or binary records) in constant memory, with text
+// files split between worker threads. Compile together with archive.c,
+// record.c and board.c, link with -pthread.
+
+#define AGG_MAX_NAMES 4096  // Player names tracked; any beyond count as "(other)"
+
+// Outcomes of a group of games
+typedef struct {
+    long long games;
+    long long wins[BOARD_MAX_PLAYERS];  // By symbol: X, O, Z
+    long long draws;
+    long long moves;                    // All moves, for the average game length
+} ResultTally;
+
+typedef struct {
+    char name[ARCHIVE_NAME_MAX];        // Empty = unused slot
+    long long games;
+    long long wins;
+    long long draws;
+} PlayerTally;
+
+typedef struct {
+    ResultTally total;
+    ResultTally bySize[BOARD_MAX_SIZE + 1];
+    ResultTally byMode[4];              // Modes 1 to 3
+    long long openings[BOARD_MAX_SIZE + 1][BOARD_MAX_CELLS];     // Games opened on each cell
+    long long openingWins[BOARD_MAX_SIZE + 1][BOARD_MAX_CELLS];  // ... that the first mover won
+    PlayerTally *players;               // Hash table of AGG_MAX_NAMES slots (text files only)
+    int playerCount;
+    PlayerTally others;                 // Every name that did not fit in the table
+    long long malformed;                // Games that could not be parsed
+    long long bytes;                    // Input bytes read
+    int files;
+} Aggregate;
+
+// Start empty; returns 0 if out of memory
+int aggInit(Aggregate *agg);
+void aggFree(Aggregate *agg);
+
+// Count one game (record->names may be NULL)
+void aggAddGame(Aggregate *agg, const GameRecord *record);
+
+// Add everything from "from" into "into"
+void aggMerge(Aggregate *into, const Aggregate *from);
+
+// Count the games in bytes [begin, end) of a mapped archive - begin must be
+// where a game starts, and a game that starts before end is counted whole
+void aggScan(Aggregate *agg, const Archive *archive, size_t begin, size_t end);
+
+// Count every game in the file at path, text files split over up to threads
+// workers. Returns 0 if the file cannot be mapped or memory runs out.
+int aggFile(Aggregate *agg, const char *path, int threads);
+
+// Summary table (win rates per symbol, size, mode and player, game length,
+// first-move advantage) and the same data as JSON
+void aggPrintTable(FILE *out, const Aggregate *agg);
+void aggPrintJson(FILE *out, const Aggregate *agg);
+
+#endif
@@ -0,0 +1,488 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "ai.h"
+#include "timer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define MAX_PLY BOARD_MAX_CELLS
+#define INF_SCORE (AI_WIN_SCORE + 1)
+#define MATE_BOUND (AI_WIN_SCORE - MAX_PLY)  // Scores beyond this are forced wins/losses
+#define NO_MOVE 255
+
+// Transposition table bound types
+#define TT_EXACT 1
+#define TT_LOWER 2  // Search failed high - score is at least this
+#define TT_UPPER 3  // Search failed low - score is at most this
+
+// One table slot: score/depth/flag/move packed in 64 bits, stored next to
+// (key ^ data). All threads share the table without locks: a slot torn by
+// two concurrent writers no longer XORs back to its key and is ignored.
+typedef struct {
+    _Atomic uint64_t check;
+    _Atomic uint64_t data;
+} TTEntry;
+
+// State owned by one search thread
+typedef struct {
+    AiContext *ai;
+    int id;
+    unsigned char killers[MAX_PLY][2];                // Quiet moves that caused cut-offs per ply
+    int history[BOARD_MAX_PLAYERS][BOARD_MAX_CELLS];  // Cut-off counts per player and cell
+    Board board;          // The thread's copy of the root, moves made and unmade in place
+    long long nodes;
+    int bestCell;         // Best root move of the current iteration
+    int bestReply;        // Best answer to it (ply 1), NO_MOVE if unknown
+    int lastReply;        // Best move of the ply-1 node searched last
+    int completedDepth;   // Deepest iteration this thread finished
+    int completedScore;
+    int completedCell;
+    int completedReply;
+    // Threads sit side by side in one array: keep the next thread's killers
+    // off the cache line holding this thread's node count (written at every
+    // node), or the line bounces between cores
+    char pad[64];
+} AiThread;
+
+struct AiContext {
+    TTEntry *table;
+    uint64_t tableMask;
+    int threadCount;
+    AiThread *threads;
+
+    // Per-search state shared by all threads
+    const Board *root;
+    int rootPlayer;
+    uint64_t rootKey;  // Mixed into table keys when scores depend on who is searching
+    uint64_t rootHashes[BOARD_SYMMETRIES];  // Root position's hash under each symmetry
+    int maxDepth;
+    double deadline;   // 0 = no time limit
+    atomic_int *stopRequest;  // AiLimits.stop
+    atomic_int stopped;
+    unsigned char centerOrder[BOARD_MAX_CELLS];  // Center-first bonus per cell
+
+    // Symmetric positions share table entries (see boardCanonicalHash): the
+    // cell each cell maps to and the Zobrist key of each player's mark there,
+    // per symmetry, for the size being searched
+    unsigned char symmetryCell[BOARD_SYMMETRIES][BOARD_MAX_CELLS];
+    uint64_t symmetryKey[BOARD_SYMMETRIES][BOARD_MAX_PLAYERS][BOARD_MAX_CELLS];
+};
+
+static uint64_t packEntry(int score, int depth, int flag, int move) {
+    return (uint64_t)(uint16_t)(int16_t)score |
+           (uint64_t)(depth & 0xFF) << 16 |
+           (uint64_t)(flag & 0xFF) << 24 |
+           (uint64_t)(move & 0xFF) << 32;
+}
+
+static int entryScore(uint64_t data) { return (int16_t)(uint16_t)(data & 0xFFFF); }
+static int entryDepth(uint64_t data) { return (int)((data >> 16) & 0xFF); }
+static int entryFlag(uint64_t data) { return (int)((data >> 24) & 0xFF); }
+static int entryMove(uint64_t data) { return (int)((data >> 32) & 0xFF); }
+
+// Win scores are stored relative to the node so they stay valid at any ply
+static int scoreToTable(int score, int ply) {
+    if (score > MATE_BOUND) return score + ply;
+    if (score < -MATE_BOUND) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply) {
+    if (score > MATE_BOUND) return score - ply;
+    if (score < -MATE_BOUND) return score + ply;
+    return score;
+}
+
+static uint64_t tableProbe(const AiContext *ai, uint64_t key) {
+    TTEntry *entry = &ai->table[key & ai->tableMask];
+    uint64_t data = atomic_load_explicit(&entry->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&entry->check, memory_order_relaxed);
+    return (data != 0 && (check ^ data) == key) ? data : 0;
+}
+
+static void tableStore(AiContext *ai, uint64_t key, uint64_t data) {
+    TTEntry *entry = &ai->table[key & ai->tableMask];
+    atomic_store_explicit(&entry->check, key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&entry->data, data, memory_order_relaxed);
+}
+
+int aiDefaultThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cores = (int)info.dwNumberOfProcessors;
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1) cores = 1;
+    return (cores > AI_MAX_THREADS) ? AI_MAX_THREADS : cores;
+}
+
+AiContext *aiCreate(int ttBits, int threads) {
+    AiContext *ai = (AiContext *)calloc(1, sizeof(AiContext));
+    if (ai == NULL) return NULL;
+
+    if (threads < 1) threads = 1;
+    if (threads > AI_MAX_THREADS) threads = AI_MAX_THREADS;
+    size_t entries = (size_t)1 << ttBits;
+    ai->table = (TTEntry *)calloc(entries, sizeof(TTEntry));
+    ai->threads = (AiThread *)calloc((size_t)threads, sizeof(AiThread));
+    if (ai->table == NULL || ai->threads == NULL) {
+        aiDestroy(ai);
+        return NULL;
+    }
+    ai->tableMask = entries - 1;
+    ai->threadCount = threads;
+    for (int i = 0; i < threads; i++) {
+        ai->threads[i].ai = ai;
+        ai->threads[i].id = i;
+        memset(ai->threads[i].killers, NO_MOVE, sizeof(ai->threads[i].killers));
+    }
+    return ai;
+}
+
+void aiDestroy(AiContext *ai) {
+    if (ai == NULL) return;
+    free(ai->table);
+    free(ai->threads);
+    free(ai);
+}
+
+void aiClear(AiContext *ai) {
+    memset(ai->table, 0, (ai->tableMask + 1) * sizeof(TTEntry));
+    for (int i = 0; i < ai->threadCount; i++) {
+        memset(ai->threads[i].killers, NO_MOVE, sizeof(ai->threads[i].killers));
+        memset(ai->threads[i].history, 0, sizeof(ai->threads[i].history));
+    }
+}
+
+// Players on the Computer's side share a sign: only the root player in
+// a 2-player game, and the root player alone against the other two in 3-player
+static int sameTeam(const AiContext *ai, int a, int b) {
+    return (a == ai->rootPlayer) == (b == ai->rootPlayer);
+}
+
+// Static evaluation from the point of view of the team of player toMove:
+// every line (or, for k in a row, every k-cell window) that only one side
+// has marks in is worth marks^2 to that side
+static int evaluate(const AiContext *ai, const Board *board, int toMove) {
+    int score = 0;
+    if (board->winLength < board->size) {
+        int counts[BOARD_MAX_SIZE + 1];
+        for (int p = 0; p < board->players; p++) {
+            boardWindowCounts(board, p, counts);
+            int worth = 0;
+            for (int marks = 1; marks < board->winLength; marks++) worth += marks * marks * counts[marks];
+            score += sameTeam(ai, p, toMove) ? worth : -worth;
+        }
+        return score;
+    }
+    for (int line = 0; line < board->lineCount; line++) {
+        unsigned char owners = board->lineOwners[line];
+        if (owners == 0 || (owners & (owners - 1)) != 0) continue;  // Empty or dead line
+
+        int p = 0;
+        while (!(owners & (1u << p))) p++;
+        int marks = board->lineMarks[p][line];
+        score += sameTeam(ai, p, toMove) ? marks * marks : -marks * marks;
+    }
+    return score;
+}
+
+// Order moves: for k in a row, cells that win at once and then cells that
+// block the next player's win come first; then the table move, killers,
+// history and closeness to the center. Helper threads add a little noise at
+// the root so they explore different moves first.
+static int orderMoves(const AiThread *t, const Board *board, int toMove, int ply, int ttMove,
+                      unsigned char *moves, int *scores) {
+    const AiContext *ai = t->ai;
+    BitBoard wins = {{ 0, 0 }}, blocks = {{ 0, 0 }};
+    if (board->winLength < board->size) {
+        wins = boardThreats(board, toMove);
+        blocks = boardThreats(board, (toMove + 1) % board->players);
+    }
+
+    int count = 0;
+    for (int cell = 0; cell < board->cells; cell++) {
+        if (bitTest(&board->occupied, cell)) continue;
+
+        int score = ai->centerOrder[cell] + t->history[toMove][cell] * 4;
+        if (ply == 0 && t->id > 0) score += (int)(zobristKey(t->id, cell) & 15);
+        if (bitTest(&wins, cell)) score = 1 << 30;
+        else if (bitTest(&blocks, cell)) score = 1 << 29;
+        else if (cell == ttMove) score = 1 << 28;
+        else if (cell == t->killers[ply][0]) score = 1 << 27;
+        else if (cell == t->killers[ply][1]) score = 1 << 26;
+
+        moves[count] = (unsigned char)cell;
+        scores[count] = score;
+        count++;
+    }
+    return count;
+}
+
+// Swap the best remaining move into position i (selection sort, one step at a time)
+static void pickMove(unsigned char *moves, int *scores, int count, int i) {
+    int best = i;
+    for (int j = i + 1; j < count; j++) {
+        if (scores[j] > scores[best]) best = j;
+    }
+    unsigned char m = moves[i]; moves[i] = moves[best]; moves[best] = m;
+    int s = scores[i]; scores[i] = scores[best]; scores[best] = s;
+}
+
+static int isStopped(AiThread *t) {
+    AiContext *ai = t->ai;
+    if ((t->nodes & 1023) == 0 &&
+        ((ai->deadline > 0 && nowSeconds() >= ai->deadline) ||
+         (ai->stopRequest != NULL && atomic_load_explicit(ai->stopRequest, memory_order_relaxed)))) {
+        atomic_store_explicit(&ai->stopped, 1, memory_order_relaxed);
+    }
+    return atomic_load_explicit(&ai->stopped, memory_order_relaxed);
+}
+
+// Negamax with alpha-beta: returns the score for the team of toMove.
+// K-in-a-row moves are made and unmade on board in place, so board is back
+// to the same position on return. Full-line boards copy the board per move
+// instead: restoring their per-line counters in boardUnplace costs more
+// than the copy. hashes holds the position's hash
+// under every symmetry; the table is keyed on the smallest, with moves
+// stored as seen from that canonical position.
+static int negamax(AiThread *t, Board *board, const uint64_t *hashes, int toMove, int depth, int ply,
+                   int alpha, int beta) {
+    AiContext *ai = t->ai;
+    t->nodes++;
+    if (isStopped(t)) return 0;
+
+    int alphaOrig = alpha;
+    int ttMove = NO_MOVE;
+    int symmetry = 0;
+    for (int s = 1; s < BOARD_SYMMETRIES; s++) {
+        if (hashes[s] < hashes[symmetry]) symmetry = s;
+    }
+    uint64_t key = hashes[symmetry] ^ ai->rootKey;
+
+    // Transposition table probe
+    uint64_t data = tableProbe(ai, key);
+    if (data != 0) {
+        ttMove = entryMove(data);
+        if (ttMove != NO_MOVE) ttMove = ai->symmetryCell[boardSymmetryInverse(symmetry)][ttMove];
+        if (ply == 1) t->lastReply = ttMove;  // Kept if the table answers this node
+        if (ply > 0 && entryDepth(data) >= depth) {
+            int score = scoreFromTable(entryScore(data), ply);
+            int flag = entryFlag(data);
+            if (flag == TT_EXACT) return score;
+            if (flag == TT_LOWER && score >= beta) return score;
+            if (flag == TT_UPPER && score <= alpha) return score;
+        }
+    }
+
+    if (depth == 0) return evaluate(ai, board, toMove);
+
+    unsigned char moves[BOARD_MAX_CELLS];
+    int scores[BOARD_MAX_CELLS];
+    int count = orderMoves(t, board, toMove, ply, ttMove, moves, scores);
+
+    int next = (toMove + 1) % board->players;
+    int keepSign = sameTeam(ai, toMove, next);
+    int copyMake = board->winLength == board->size;
+    int best = -INF_SCORE;
+    int bestMove = NO_MOVE;
+
+    for (int i = 0; i < count; i++) {
+        pickMove(moves, scores, count, i);
+        int cell = moves[i];
+        int row = cell / board->size, col = cell % board->size;
+
+        Board child;
+        Board *pos = board;
+        if (copyMake) {
+            child = *board;
+            pos = &child;
+        }
+
+        int score;
+        if (boardPlace(pos, row, col, toMove)) {
+            score = AI_WIN_SCORE - (ply + 1);  // Winning now beats winning later
+        } else if (boardIsDraw(pos)) {
+            score = 0;
+        } else {
+            uint64_t childHashes[BOARD_SYMMETRIES];
+            for (int s = 0; s < BOARD_SYMMETRIES; s++) childHashes[s] = hashes[s] ^ ai->symmetryKey[s][toMove][cell];
+            if (keepSign) {
+                score = negamax(t, pos, childHashes, next, depth - 1, ply + 1, alpha, beta);
+            } else {
+                score = -negamax(t, pos, childHashes, next, depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+        if (!copyMake) boardUnplace(board, row, col, toMove);
+        if (atomic_load_explicit(&ai->stopped, memory_order_relaxed)) return 0;
+
+        if (score > best) {
+            best = score;
+            bestMove = cell;
+            if (ply == 0) {
+                t->bestCell = cell;
+                t->bestReply = t->lastReply;
+            }
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            // Remember the refutation for sibling nodes
+            if (t->killers[ply][0] != cell) {
+                t->killers[ply][1] = t->killers[ply][0];
+                t->killers[ply][0] = (unsigned char)cell;
+            }
+            t->history[toMove][cell] += depth * depth;
+            break;
+        }
+    }
+
+    int flag = TT_EXACT;
+    if (best <= alphaOrig) flag = TT_UPPER;
+    else if (best >= beta) flag = TT_LOWER;
+    if (ply == 1) t->lastReply = bestMove;
+    if (bestMove != NO_MOVE) bestMove = ai->symmetryCell[symmetry][bestMove];
+    tableStore(ai, key, packEntry(scoreToTable(best, ply), depth, flag, bestMove));
+    return best;
+}
+
+// Iterative deepening for one thread. Lazy SMP: every thread searches the
+// same root and they share only the transposition table; odd helpers start
+// one ply deeper so the threads spread over different depths.
+static void *searchThread(void *arg) {
+    AiThread *t = (AiThread *)arg;
+    AiContext *ai = t->ai;
+
+    t->board = *ai->root;
+    for (int depth = 1 + (t->id & 1); depth <= ai->maxDepth; depth++) {
+        t->bestCell = -1;
+        t->bestReply = NO_MOVE;
+        int score = negamax(t, &t->board, ai->rootHashes, ai->rootPlayer, depth, 0, -INF_SCORE, INF_SCORE);
+        if (atomic_load_explicit(&ai->stopped, memory_order_relaxed)) break;
+
+        t->completedDepth = depth;
+        t->completedScore = score;
+        t->completedCell = t->bestCell;
+        t->completedReply = t->bestReply;
+        if (score > MATE_BOUND || score < -MATE_BOUND) break;  // Forced result found
+    }
+
+    // The main thread decides when the search is over
+    if (t->id == 0) atomic_store_explicit(&ai->stopped, 1, memory_order_relaxed);
+    return NULL;
+}
+
+// What the search expects the next player to answer to cell (lets the
+// caller ponder on it): the second move of the principal variation, or the
+// table's move for the position after cell when the variation stops short
+static void expectedReply(const AiContext *ai, const Board *board, int player, int cell, int reply,
+                          AiResult *result) {
+    Board child = *board;
+    result->replyRow = result->replyCol = -1;
+    if (boardPlace(&child, cell / board->size, cell % board->size, player) || boardIsDraw(&child)) return;
+
+    if (reply == NO_MOVE) {
+        int symmetry;
+        uint64_t data = tableProbe(ai, boardCanonicalHash(&child, &symmetry) ^ ai->rootKey);
+        reply = (data != 0) ? entryMove(data) : NO_MOVE;
+        if (reply == NO_MOVE) return;
+        reply = ai->symmetryCell[boardSymmetryInverse(symmetry)][reply];
+    }
+    if (bitTest(&child.occupied, reply)) return;  // Table slot reused by another position
+    result->replyRow = reply / board->size;
+    result->replyCol = reply % board->size;
+}
+
+void aiSearch(AiContext *ai, const Board *board, int player, const AiLimits *limits, AiResult *result) {
+    double start = nowSeconds();
+    int size = board->size;
+    int emptyCells = board->cells - board->moveCount;
+
+    ai->root = board;
+    ai->rootPlayer = player;
+    // 2-player scores are symmetric; with 3 players the teams depend on the searcher
+    ai->rootKey = (board->players > 2) ? zobristKey(player, BOARD_MAX_CELLS) : 0;
+    ai->maxDepth = (limits->maxDepth > 0 && limits->maxDepth < emptyCells) ? limits->maxDepth : emptyCells;
+    ai->deadline = (limits->timeLimit > 0) ? start + limits->timeLimit : 0;
+    ai->stopRequest = limits->stop;
+    atomic_store(&ai->stopped, 0);
+
+    // Static ordering: cells closer to the center first
+    for (int cell = 0; cell < board->cells; cell++) {
+        int dr = 2 * (cell / size) - (size - 1);
+        int dc = 2 * (cell % size) - (size - 1);
+        int dist = abs(dr) + abs(dc);
+        ai->centerOrder[cell] = (unsigned char)(4 * size - dist);
+    }
+
+    // Symmetry tables for this size (the Zobrist keys are fixed, so the
+    // canonical keys stay valid across searches)
+    for (int s = 0; s < BOARD_SYMMETRIES; s++) {
+        for (int cell = 0; cell < board->cells; cell++) {
+            int image = boardSymmetryCell(size, s, cell);
+            ai->symmetryCell[s][cell] = (unsigned char)image;
+            for (int p = 0; p < board->players; p++) ai->symmetryKey[s][p][cell] = zobristKey(p, image);
+        }
+    }
+    boardSymmetryHashes(board, ai->rootHashes);
+
+    for (int i = 0; i < ai->threadCount; i++) {
+        AiThread *t = &ai->threads[i];
+        t->nodes = 0;
+        t->completedDepth = 0;
+        t->completedScore = 0;
+        t->completedCell = -1;
+        t->completedReply = NO_MOVE;
+        memset(t->killers, NO_MOVE, sizeof(t->killers));
+        // Age the history table so old cut-offs fade out
+        for (int p = 0; p < BOARD_MAX_PLAYERS; p++) {
+            for (int cell = 0; cell < BOARD_MAX_CELLS; cell++) t->history[p][cell] /= 2;
+        }
+    }
+
+    // Helpers run on their own threads, the main search runs on this one
+    pthread_t helpers[AI_MAX_THREADS];
+    int started = 0;
+    for (int i = 1; i < ai->threadCount; i++) {
+        if (pthread_create(&helpers[started], NULL, searchThread, &ai->threads[i]) != 0) break;
+        started++;
+    }
+    searchThread(&ai->threads[0]);
+    for (int i = 0; i < started; i++) {
+        pthread_join(helpers[i], NULL);
+    }
+
+    // Take the deepest finished iteration; the main thread wins ties
+    AiThread *best = &ai->threads[0];
+    long long nodes = 0;
+    for (int i = 0; i < ai->threadCount; i++) {
+        AiThread *t = &ai->threads[i];
+        nodes += t->nodes;
+        if (t->completedCell >= 0 && (best->completedCell < 0 || t->completedDepth > best->completedDepth)) {
+            best = t;
+        }
+    }
+
+    // Fallback move in case not even depth 1 finished in time
+    int bestCell = best->completedCell;
+    for (int cell = 0; cell < board->cells && bestCell < 0; cell++) {
+        if (!bitTest(&board->occupied, cell)) bestCell = cell;
+    }
+
+    result->row = bestCell / size;
+    result->col = bestCell % size;
+    expectedReply(ai, board, player, bestCell, best->completedCell == bestCell ? best->completedReply : NO_MOVE,
+                  result);
+    result->score = best->completedScore;
+    result->depth = best->completedDepth;
+    result->nodes = nodes;
+    result->seconds = nowSeconds() - start;
+    result->nodesPerSec = (result->seconds > 0) ? (double)nodes / result->seconds : 0;
+}
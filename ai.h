@@ -0,0 +1,55 @@
+#ifndef AI_H
+#define AI_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "board.h"
+
+// Search engine for the Computer player: negamax with alpha-beta pruning,
+// iterative deepening, move ordering and a Zobrist-hashed transposition table.
+// With three players the search is "paranoid": the other two players are
+// treated as one team playing against the Computer.
+// Searches can run on several threads (lazy SMP) - link with -pthread.
+
+#define AI_DEFAULT_TIME 1.0    // Seconds per move when nothing else is chosen
+#define AI_DEFAULT_TT_BITS 20  // 2^20 transposition table entries (16 MB)
+#define AI_MAX_THREADS 64      // Upper limit for --threads
+
+// Limits for one search - the search stops at whichever is reached first
+typedef struct {
+    double timeLimit;  // Seconds per move (0 = no time limit)
+    int maxDepth;      // Deepest iteration in plies (0 = until the board is full)
+    atomic_int *stop;  // Set to nonzero from another thread to end the search now (NULL = none)
+} AiLimits;
+
+// What the search found and how much work it did
+typedef struct {
+    int row, col;        // Chosen move (0-based)
+    int replyRow, replyCol;  // The next player's best answer to it, as far as the search saw (-1 = unknown)
+    int score;           // Score for the Computer (> 0 is good, +/-AI_WIN_SCORE is a forced win/loss)
+    int depth;           // Deepest fully completed iteration
+    long long nodes;     // Positions visited
+    double seconds;      // Wall-clock time used
+    double nodesPerSec;  // nodes / seconds
+} AiResult;
+
+#define AI_WIN_SCORE 30000
+
+typedef struct AiContext AiContext;
+
+// Number of search threads to use when none is given: one per core
+int aiDefaultThreads(void);
+
+// Create a search context with a 2^ttBits entry transposition table shared
+// by all search threads. The table is kept between moves so later
+// searches reuse earlier work.
+AiContext *aiCreate(int ttBits, int threads);
+void aiDestroy(AiContext *ai);
+
+// Forget everything learnt so far (call before a new game)
+void aiClear(AiContext *ai);
+
+// Pick a move for player on board (board must not be finished)
+void aiSearch(AiContext *ai, const Board *board, int player, const AiLimits *limits, AiResult *result);
+
+#endif
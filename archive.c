@@ -0,0 +1,423 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "archive.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define INDEX_MAGIC "TTTI"
+#define INDEX_VERSION 1
+#define INDEX_HEADER 40          // magic, version, indexed bytes, count, fingerprint
+#define FINGERPRINT_BYTES 4096   // Start of the archive the fingerprint covers
+
+// Growable list of game offsets
+typedef struct {
+    uint64_t *items;
+    long long count;
+    long long capacity;
+} OffsetList;
+
+static int offsetPush(OffsetList *list, uint64_t offset) {
+    if (list->count == list->capacity) {
+        long long capacity = list->capacity ? 2 * list->capacity : 1024;
+        uint64_t *items = (uint64_t *)realloc(list->items, (size_t)capacity * sizeof(uint64_t));
+        if (items == NULL) return 0;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = offset;
+    return 1;
+}
+
+int archiveMapFile(const char *path, void **map, size_t *size) {
+    *map = NULL;
+    *size = 0;
+#ifdef _WIN32
+    // No mmap here: read the file into memory instead
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (length > 0) {
+        *map = malloc((size_t)length);
+        if (*map == NULL || fread(*map, 1, (size_t)length, file) != (size_t)length) {
+            free(*map);
+            *map = NULL;
+            fclose(file);
+            return 0;
+        }
+        *size = (size_t)length;
+    }
+    fclose(file);
+    return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return 0;
+    }
+    if (info.st_size > 0) {
+        void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+        *map = data;
+        *size = (size_t)info.st_size;
+    }
+    close(fd);  // The mapping stays valid
+    return 1;
+#endif
+}
+
+void archiveUnmapFile(void *map, size_t size) {
+    if (map == NULL) return;
+#ifdef _WIN32
+    (void)size;
+    free(map);
+#else
+    munmap(map, size);
+#endif
+}
+
+// FNV-1a over the start of the archive - tells a grown file from a replaced one
+static uint64_t fingerprint(const unsigned char *data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    size_t length = size < FINGERPRINT_BYTES ? size : FINGERPRINT_BYTES;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static int startsWith(const unsigned char *p, const unsigned char *end, const char *text) {
+    size_t length = strlen(text);
+    return (size_t)(end - p) >= length && memcmp(p, text, length) == 0;
+}
+
+// Find text between p and end; NULL if absent
+static const unsigned char *findText(const unsigned char *p, const unsigned char *end, const char *text) {
+    size_t length = strlen(text);
+    while ((size_t)(end - p) >= length) {
+        const unsigned char *first = (const unsigned char *)memchr(p, text[0], (size_t)(end - p));
+        if (first == NULL || (size_t)(end - first) < length) return NULL;
+        if (memcmp(first, text, length) == 0) return first;
+        p = first + 1;
+    }
+    return NULL;
+}
+
+// Read a decimal number at *p and move past it; -1 if there is none
+static int parseNumber(const unsigned char **p, const unsigned char *end) {
+    int value = 0, digits = 0;
+    while (*p < end && **p >= '0' && **p <= '9' && digits < 9) {
+        value = value * 10 + (**p - '0');
+        (*p)++;
+        digits++;
+    }
+    return digits ? value : -1;
+}
+
+// Index the games from offset on, appending the end of each complete game to list.
+// Returns the offset just after the last complete game.
+static uint64_t scanGames(const Archive *archive, uint64_t offset, OffsetList *list) {
+    const unsigned char *data = archive->data;
+    size_t size = archive->size;
+
+    if (archive->format == ARCHIVE_BINARY) {
+        while (offset + RECORD_HEADER <= size) {
+            GameRecord record;
+            long used = recordDecode(data + offset, size - offset, archive->version, &record);
+            if (used <= 0) break;  // Truncated or corrupt: stop at the last good game
+            offset += (uint64_t)used;
+            if (!offsetPush(list, offset)) break;
+        }
+        return offset;
+    }
+
+    // Text: a game ends with its "-----" separator line
+    size_t end;
+    while ((end = archiveTextGameEnd(data, size, (size_t)offset)) != 0) {
+        if (!offsetPush(list, end)) break;
+        offset = end;
+    }
+    return offset;
+}
+
+// Use the saved index if it belongs to this archive; extend it if the archive
+// grew. Returns 1 with list filled (or the index mapped), 0 to rebuild.
+static int loadIndex(Archive *archive, const char *indexPath, OffsetList *list) {
+    void *map;
+    size_t mapSize;
+    if (!archiveMapFile(indexPath, &map, &mapSize)) return 0;
+
+    const unsigned char *header = (const unsigned char *)map;
+    uint64_t indexed, count, print;
+    uint32_t version;
+    if (mapSize < INDEX_HEADER || memcmp(header, INDEX_MAGIC, 4) != 0) {
+        archiveUnmapFile(map, mapSize);
+        return 0;
+    }
+    memcpy(&version, header + 4, 4);
+    memcpy(&indexed, header + 8, 8);
+    memcpy(&count, header + 16, 8);
+    memcpy(&print, header + 24, 8);
+    const uint64_t *offsets = (const uint64_t *)(header + INDEX_HEADER);
+    if (version != INDEX_VERSION || count >= mapSize / sizeof(uint64_t) ||
+        mapSize != INDEX_HEADER + (count + 1) * sizeof(uint64_t) ||
+        indexed > archive->size || offsets[count] != indexed ||
+        print != fingerprint(archive->data, (size_t)indexed)) {
+        archiveUnmapFile(map, mapSize);
+        return 0;
+    }
+
+    if (indexed == archive->size) {
+        // Up to date: use the mapped offsets directly
+        archive->indexMap = map;
+        archive->indexMapSize = mapSize;
+        archive->offsets = offsets;
+        archive->count = (long long)count;
+        archive->indexLoaded = 1;
+        return 1;
+    }
+
+    // The archive grew: keep the known games and scan only the new bytes
+    for (uint64_t k = 0; k <= count; k++) {
+        if (!offsetPush(list, offsets[k])) {
+            archiveUnmapFile(map, mapSize);
+            return 0;
+        }
+    }
+    archiveUnmapFile(map, mapSize);
+    scanGames(archive, list->items[list->count - 1], list);
+    return 1;
+}
+
+static void saveIndex(const Archive *archive, const char *indexPath) {
+    size_t pathLength = strlen(indexPath);
+    char *tempPath = (char *)malloc(pathLength + 5);
+    if (tempPath == NULL) return;
+    memcpy(tempPath, indexPath, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+
+    FILE *file = fopen(tempPath, "wb");
+    if (file != NULL) {
+        unsigned char header[INDEX_HEADER];
+        uint32_t version = INDEX_VERSION;
+        uint64_t count = (uint64_t)archive->count;
+        uint64_t indexed = archive->offsets[archive->count];
+        uint64_t print = fingerprint(archive->data, (size_t)indexed);
+        memcpy(header, INDEX_MAGIC, 4);
+        memcpy(header + 4, &version, 4);
+        memcpy(header + 8, &indexed, 8);
+        memcpy(header + 16, &count, 8);
+        memcpy(header + 24, &print, 8);
+        memset(header + 32, 0, INDEX_HEADER - 32);
+
+        size_t entries = (size_t)archive->count + 1;
+        int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+                 fwrite(archive->offsets, sizeof(uint64_t), entries, file) == entries;
+        ok = (fclose(file) == 0) && ok;
+        // Replace the old index in one step so readers never see half a file
+        if (!ok || rename(tempPath, indexPath) != 0) remove(tempPath);
+    }
+    free(tempPath);
+}
+
+size_t archiveTextGameEnd(const unsigned char *data, size_t size, size_t offset) {
+    while (offset < size) {
+        const unsigned char *eol = (const unsigned char *)memchr(data + offset, '\n', size - offset);
+        if (eol == NULL) return 0;  // Last line not finished yet
+        size_t next = (size_t)(eol - data) + 1;
+        if (startsWith(data + offset, eol, "-----")) return next;
+        offset = next;
+    }
+    return 0;
+}
+
+int archiveMap(Archive *archive, const char *path) {
+    memset(archive, 0, sizeof(*archive));
+    if (!archiveMapFile(path, &archive->dataMap, &archive->size)) return 0;
+    archive->data = (const unsigned char *)archive->dataMap;
+
+    archive->format = ARCHIVE_TEXT;
+    if (archive->size >= RECORD_FILE_HEADER && memcmp(archive->data, RECORD_MAGIC, 4) == 0) {
+        archive->format = ARCHIVE_BINARY;
+        archive->version = recordFileVersion(archive->data);
+        if (archive->version > RECORD_VERSION) {  // Written by a newer program
+            archiveClose(archive);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+size_t archiveFirstGame(const Archive *archive) {
+    return archive->format == ARCHIVE_BINARY ? RECORD_FILE_HEADER : 0;
+}
+
+int archiveOpen(Archive *archive, const char *path, int useIndex) {
+    if (!archiveMap(archive, path)) return 0;
+    uint64_t first = archiveFirstGame(archive);
+#ifndef _WIN32
+    // The first pass reads the whole file front to back
+    if (archive->size > 0) posix_madvise(archive->dataMap, archive->size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    char *indexPath = NULL;
+    if (useIndex) {
+        size_t length = strlen(path);
+        indexPath = (char *)malloc(length + 5);
+        if (indexPath != NULL) {
+            memcpy(indexPath, path, length);
+            memcpy(indexPath + length, ".idx", 5);
+        }
+    }
+
+    OffsetList list = { NULL, 0, 0 };
+    int loaded = indexPath != NULL && loadIndex(archive, indexPath, &list);
+    if (!loaded) {
+        // Build the index from scratch
+        list.count = 0;
+        if (!offsetPush(&list, first)) {
+            free(indexPath);
+            archiveClose(archive);
+            return 0;
+        }
+        scanGames(archive, first, &list);
+    }
+    if (archive->offsets == NULL) {
+        archive->ownOffsets = list.items;
+        archive->offsets = list.items;
+        archive->count = list.count - 1;
+        if (indexPath != NULL) saveIndex(archive, indexPath);
+    }
+    free(indexPath);
+
+#ifndef _WIN32
+    if (archive->size > 0) posix_madvise(archive->dataMap, archive->size, POSIX_MADV_NORMAL);
+#endif
+    return 1;
+}
+
+void archiveClose(Archive *archive) {
+    archiveUnmapFile(archive->dataMap, archive->size);
+    archiveUnmapFile(archive->indexMap, archive->indexMapSize);
+    free(archive->ownOffsets);
+    memset(archive, 0, sizeof(*archive));
+}
+
+const unsigned char *archiveGameBytes(const Archive *archive, long long k, size_t *length) {
+    if (k < 0 || k >= archive->count) return NULL;
+    *length = (size_t)(archive->offsets[k + 1] - archive->offsets[k]);
+    return archive->data + archive->offsets[k];
+}
+
+// Copy the names from "Players: Alice (X), Bob (O)" (line without its newline)
+static void parsePlayerNames(const unsigned char *p, const unsigned char *eol, char names[][ARCHIVE_NAME_MAX]) {
+    for (int i = 0; i < BOARD_MAX_PLAYERS && p < eol; i++) {
+        const unsigned char *symbol = findText(p, eol, " (");
+        if (symbol == NULL) break;
+        size_t length = (size_t)(symbol - p);
+        if (length >= ARCHIVE_NAME_MAX) length = ARCHIVE_NAME_MAX - 1;
+        memcpy(names[i], p, length);
+        names[i][length] = '\0';
+
+        p = symbol + 2;  // Past " (" to "X), Bob (O)"
+        if (!startsWith(p + 1, eol, "), ")) break;
+        p += 4;
+    }
+}
+
+int archiveParseText(const unsigned char *bytes, size_t length, GameRecord *record, char names[][ARCHIVE_NAME_MAX]) {
+    const unsigned char *p = bytes, *end = bytes + length;
+    unsigned char rows[BOARD_MAX_CELLS], cols[BOARD_MAX_CELLS];
+    int moves = 0, mode = 0, size = 0, winLength = 0, won = -1;
+
+    if (names != NULL) {
+        for (int i = 0; i < BOARD_MAX_PLAYERS; i++) names[i][0] = '\0';
+    }
+
+    while (p < end) {
+        const unsigned char *eol = (const unsigned char *)memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL) eol = end;
+
+        if (startsWith(p, eol, "Move ")) {
+            // "Move 3: Alice (X) -> Row 2, Col 1"
+            const unsigned char *at = findText(p, eol, "-> Row ");
+            if (at == NULL || moves == BOARD_MAX_CELLS) return 0;
+            at += 7;
+            int row = parseNumber(&at, eol);
+            if (!startsWith(at, eol, ", Col ")) return 0;
+            at += 6;
+            int col = parseNumber(&at, eol);
+            if (row < 1 || col < 1 || row > BOARD_MAX_SIZE || col > BOARD_MAX_SIZE) return 0;
+            rows[moves] = (unsigned char)(row - 1);
+            cols[moves] = (unsigned char)(col - 1);
+            moves++;
+        } else if (startsWith(p, eol, "Undo ")) {
+            if (moves > 0) moves--;  // "Undo 3: ..." takes back the last move
+        } else if (startsWith(p, eol, "Game abandoned")) {
+            moves = 0;  // The moves so far belonged to a game that never finished
+        } else if (startsWith(p, eol, "Game Mode: ")) {
+            const unsigned char *at = p + 11;
+            mode = parseNumber(&at, eol);
+        } else if (startsWith(p, eol, "Board Size: ")) {
+            const unsigned char *at = p + 12;
+            size = parseNumber(&at, eol);
+        } else if (startsWith(p, eol, "Win Length: ")) {
+            const unsigned char *at = p + 12;
+            winLength = parseNumber(&at, eol);
+        } else if (names != NULL && startsWith(p, eol, "Players: ")) {
+            parsePlayerNames(p + 9, eol, names);
+        } else if (startsWith(p, eol, "Winner: ")) {
+            won = 1;
+        } else if (startsWith(p, eol, "Result: Draw")) {
+            won = 0;
+        }
+        p = eol + 1;
+    }
+
+    if (winLength == 0) winLength = size;  // No "Win Length:" line - the full-line rule
+    if (size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE || mode < 1 || mode > 3 || won < 0 || moves > size * size ||
+        winLength < BOARD_MIN_SIZE || winLength > size) {
+        return 0;
+    }
+    memset(record, 0, sizeof(*record));
+    record->size = size;
+    record->winLength = winLength;
+    record->mode = mode;
+    record->players = (mode == 3) ? 3 : 2;
+    record->moveCount = moves;
+    for (int i = 0; i < moves; i++) {
+        if (rows[i] >= size || cols[i] >= size) return 0;
+        record->moves[i] = (unsigned char)(rows[i] * size + cols[i]);
+    }
+    // The winner made the last move
+    record->winner = (won && moves > 0) ? (moves - 1) % record->players : -1;
+    if (names != NULL) {
+        for (int i = 0; i < record->players; i++) record->names[i] = names[i];
+    }
+    return 1;
+}
+
+int archiveGame(const Archive *archive, long long k, GameRecord *record) {
+    size_t length;
+    const unsigned char *bytes = archiveGameBytes(archive, k, &length);
+    if (bytes == NULL) return 0;
+
+    if (archive->format == ARCHIVE_BINARY) return recordDecode(bytes, length, archive->version, record) > 0;
+    if (!archiveParseText(bytes, length, record, NULL)) return 0;
+    record->number = (unsigned int)k;
+    return 1;
+}
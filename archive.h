@@ -0,0 +1,81 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "record.h"
+
+// Read-only game archive: memory-maps a results file and gives each game a
+// number, so callers can walk all games or jump straight to game K without
+// reading the file through stdio. Compile together with record.c and board.c.
+//
+// Two kinds of file are understood:
+//   - binary record files (record.h), e.g. from --log-format binary
+//   - the text results written by saveGameResult ("Move 1: ..." lines, then
+//     the "Game Mode:" ... "-----" block), e.g. multigrids.txt; "Undo" lines
+//     take back a move and "Game abandoned" drops the moves before it
+//
+// Game offsets are kept in a sidecar index "<file>.idx" (magic "TTTI"),
+// loaded with mmap as well. A missing or stale index is rebuilt; when the
+// archive only grew since it was indexed, just the new games are scanned.
+
+#define ARCHIVE_NAME_MAX 50  // Longest player name kept from text games, with its terminator
+
+typedef enum {
+    ARCHIVE_BINARY,  // Record file starting with RECORD_MAGIC
+    ARCHIVE_TEXT     // saveGameResult text blocks
+} ArchiveFormat;
+
+typedef struct {
+    ArchiveFormat format;
+    int version;                // Record format version of a binary file (record.h)
+    const unsigned char *data;  // The whole file, mapped read-only
+    size_t size;
+    long long count;            // Complete games in the file
+    const uint64_t *offsets;    // Game k is bytes offsets[k] to offsets[k + 1]
+    int indexLoaded;            // 1 if the index came from the .idx file unchanged
+
+    // Owned resources
+    void *dataMap;
+    void *indexMap;
+    size_t indexMapSize;
+    uint64_t *ownOffsets;       // Offsets built in memory (NULL when mapped)
+} Archive;
+
+// Open path. With useIndex, load or build "<path>.idx" (and save it when it
+// was built); otherwise index in memory only. Returns 0 if the file cannot
+// be mapped or memory runs out.
+int archiveOpen(Archive *archive, const char *path, int useIndex);
+void archiveClose(Archive *archive);
+
+// Map path and detect its format without indexing it (count stays 0), for
+// a single streaming pass over files of any size. Returns 0 on failure,
+// including a binary file from a newer record version.
+int archiveMap(Archive *archive, const char *path);
+
+// Offset where the first game of the mapped data starts
+size_t archiveFirstGame(const Archive *archive);
+
+// Text format: from offset (a line start), the offset just past the next
+// "-----" separator line - the end of the game starting there. 0 if the data
+// ends before a complete game.
+size_t archiveTextGameEnd(const unsigned char *data, size_t size, size_t offset);
+
+// Parse the text game in bytes[0, length). With names non-NULL the player
+// names are copied there (cut to ARCHIVE_NAME_MAX - 1 characters) and linked
+// from record->names. Returns 0 if the game is malformed.
+int archiveParseText(const unsigned char *bytes, size_t length, GameRecord *record, char names[][ARCHIVE_NAME_MAX]);
+
+// Raw bytes of game k inside the mapping - no copy. NULL if k is out of range.
+const unsigned char *archiveGameBytes(const Archive *archive, long long k, size_t *length);
+
+// Map a whole file read-only (read into memory where there is no mmap); an
+// empty file maps to (NULL, 0). Returns 0 on failure. Also used by book.c.
+int archiveMapFile(const char *path, void **map, size_t *size);
+void archiveUnmapFile(void *map, size_t size);
+
+// Decode game k into record; returns 0 if k is out of range or the game is malformed.
+// Text games get no names and seed 0; their number is k.
+int archiveGame(const Archive *archive, long long k, GameRecord *record);
+
+#endif
@@ -0,0 +1,487 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "board.h"
+#include "ai.h"
+#include "computer.h"
+#include "timer.h"
+
+// Benchmarks for the game engine.
+//   (default)   Core primitives for every board size 3 to 10 with 2 and 3
+//               players: ns/op, games/sec and heap allocations per game, for
+//               the bitboard and for the original char** board kept below as
+//               the reference. --json prints the same rows as JSON.
+//   --scaling   Nodes/sec of the Computer's search for 1, 2, 4 ... threads
+
+#define BENCH_POSITIONS 4  // Test positions searched per thread count
+
+// Build test position k on a size x size board: the first k*2 moves of a
+// fixed zig-zag pattern so every run searches exactly the same positions
+static void setupPosition(Board *board, int size, int k) {
+    boardInit(board, size, 2);
+    for (int m = 0; m < k * 2; m++) {
+        int row = (m * 3 + k) % size;
+        int col = (m * 7 + 2 * k) % size;
+        while (!boardIsValidMove(board, row, col)) col = (col + 1) % size;
+        boardPlace(board, row, col, m % 2);
+    }
+}
+
+// Search scaling: nodes/sec of the Computer's search for 1, 2, 4 ... threads
+static void benchSearchScaling(int size, int maxThreads, double seconds) {
+    printf("Search scaling on %d x %d (%.2f s per position, %d positions)\n", size, size, seconds, BENCH_POSITIONS);
+    printf("%8s %14s %10s %8s\n", "threads", "nodes/sec", "speedup", "depth");
+
+    double baseline = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > maxThreads) threads = maxThreads;  // Always finish on the full core count
+        AiContext *ai = aiCreate(AI_DEFAULT_TT_BITS, threads);
+        if (ai == NULL) {
+            printf("Not enough memory for %d threads.\n", threads);
+            return;
+        }
+
+        long long nodes = 0;
+        double elapsed = 0;
+        int depth = 0;
+        for (int k = 0; k < BENCH_POSITIONS; k++) {
+            Board board;
+            AiResult result;
+            AiLimits limits = { seconds, 0, NULL };
+            setupPosition(&board, size, k);
+            aiClear(ai);
+            aiSearch(ai, &board, board.moveCount % 2, &limits, &result);
+            nodes += result.nodes;
+            elapsed += result.seconds;
+            depth += result.depth;
+        }
+        aiDestroy(ai);
+
+        double nps = nodes / elapsed;
+        if (threads == 1) baseline = nps;
+        printf("%8d %14.0f %9.2fx %8.1f\n", threads, nps, nps / baseline, (double)depth / BENCH_POSITIONS);
+        if (threads == maxThreads) break;
+    }
+}
+
+// ---- Heap allocation counting ----------------------------------------------
+
+#if defined(__GLIBC__) && !defined(BENCH_NO_ALLOC_COUNT)
+// These replace the C library's malloc, calloc and realloc for the whole
+// program (engine files included) and forward to glibc's own entry points
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static atomic_llong allocations;
+
+void *malloc(size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+static long long allocationCount(void) {
+    return atomic_load_explicit(&allocations, memory_order_relaxed);
+}
+#define ALLOC_COUNTING 1
+#else
+static long long allocationCount(void) {
+    return 0;
+}
+#define ALLOC_COUNTING 0
+#endif
+
+// ---- Reference: the original char** board ---------------------------------
+// Kept verbatim in behaviour (one malloc per row, full scans) so the suite
+// can show what every change to the engine gained
+
+static char **legacyInitializeBoard(int size) {
+    char **board = (char **)malloc(size * sizeof(char *));
+    for (int i = 0; i < size; i++) {
+        board[i] = (char *)malloc(size * sizeof(char));
+        for (int j = 0; j < size; j++) board[i][j] = ' ';
+    }
+    return board;
+}
+
+static void legacyFreeBoard(char **board, int size) {
+    for (int i = 0; i < size; i++) free(board[i]);
+    free(board);
+}
+
+static int legacyIsValidMove(char **board, int row, int col, int size) {
+    if (row < 0 || row >= size || col < 0 || col >= size) return 0;
+    if (board[row][col] != ' ') return 0;
+    return 1;
+}
+
+static int legacyCheckWin(char **board, int size, char symbol) {
+    int win;
+    for (int i = 0; i < size; i++) {
+        win = 1;
+        for (int j = 0; j < size; j++) {
+            if (board[i][j] != symbol) { win = 0; break; }
+        }
+        if (win) return 1;
+    }
+    for (int j = 0; j < size; j++) {
+        win = 1;
+        for (int i = 0; i < size; i++) {
+            if (board[i][j] != symbol) { win = 0; break; }
+        }
+        if (win) return 1;
+    }
+    win = 1;
+    for (int i = 0; i < size; i++) {
+        if (board[i][i] != symbol) { win = 0; break; }
+    }
+    if (win) return 1;
+    win = 1;
+    for (int i = 0; i < size; i++) {
+        if (board[i][size - i - 1] != symbol) { win = 0; break; }
+    }
+    return win;
+}
+
+static int legacyCheckDraw(char **board, int size) {
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            if (board[i][j] == ' ') return 0;
+    return 1;
+}
+
+// Random empty cell by retrying, as the original computerMove did with rand()
+static void legacyComputerMove(char **board, int size, Rng *rng, int *row, int *col) {
+    do {
+        *row = (int)rngBelow(rng, (uint64_t)size);
+        *col = (int)rngBelow(rng, (uint64_t)size);
+    } while (board[*row][*col] != ' ');
+}
+
+// ---- Primitive suite -------------------------------------------------------
+
+#define BENCH_BOARDS 64     // Mid-game positions cycled through (power of two)
+#define BENCH_PROBES 256    // Cells probed by the move checks (power of two)
+
+typedef struct {
+    int size, players;
+    Board boards[BENCH_BOARDS];           // Random mid-game positions with no winner
+    char **legacy[BENCH_BOARDS];          // The same positions on char** boards
+    int probeRow[BENCH_PROBES];           // Cells to check, some off the board
+    int probeCol[BENCH_PROBES];
+    Rng rng;
+    ComputerPlayer computer;              // Random engine, as the original computerMove
+} BenchCase;
+
+typedef long long (*BenchOp)(BenchCase *bc, long long iterations);
+
+static volatile long long benchSink;      // Keeps results alive so no loop is optimised away
+
+static long long opInitBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    Board board;
+    for (long long i = 0; i < n; i++) {
+        boardInit(&board, bc->size, bc->players);
+        sum += board.liveLines;
+    }
+    return sum;
+}
+
+static long long opInitLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) {
+        char **board = legacyInitializeBoard(bc->size);
+        sum += board[0][0];
+        legacyFreeBoard(board, bc->size);
+    }
+    return sum;
+}
+
+static long long opValidBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) {
+        int p = (int)(i & (BENCH_PROBES - 1));
+        sum += boardIsValidMove(&bc->boards[i & (BENCH_BOARDS - 1)], bc->probeRow[p], bc->probeCol[p]);
+    }
+    return sum;
+}
+
+static long long opValidLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) {
+        int p = (int)(i & (BENCH_PROBES - 1));
+        sum += legacyIsValidMove(bc->legacy[i & (BENCH_BOARDS - 1)], bc->probeRow[p], bc->probeCol[p], bc->size);
+    }
+    return sum;
+}
+
+static long long opWinBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) {
+        sum += boardCheckWin(&bc->boards[i & (BENCH_BOARDS - 1)], (int)(i % bc->players));
+    }
+    return sum;
+}
+
+static long long opWinLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) {
+        sum += legacyCheckWin(bc->legacy[i & (BENCH_BOARDS - 1)], bc->size, playerToSymbol((int)(i % bc->players)));
+    }
+    return sum;
+}
+
+static long long opDrawBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) sum += boardIsDraw(&bc->boards[i & (BENCH_BOARDS - 1)]);
+    return sum;
+}
+
+static long long opDrawLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    for (long long i = 0; i < n; i++) sum += legacyCheckDraw(bc->legacy[i & (BENCH_BOARDS - 1)], bc->size);
+    return sum;
+}
+
+static long long opMoveBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    int row, col;
+    for (long long i = 0; i < n; i++) {
+        const Board *board = &bc->boards[i & (BENCH_BOARDS - 1)];
+        computerMove(&bc->computer, board, board->moveCount % bc->players, &row, &col);
+        sum += row + col;
+    }
+    return sum;
+}
+
+static long long opMoveLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    int row, col;
+    for (long long i = 0; i < n; i++) {
+        legacyComputerMove(bc->legacy[i & (BENCH_BOARDS - 1)], bc->size, &bc->rng, &row, &col);
+        sum += row + col;
+    }
+    return sum;
+}
+
+// Whole random game: set up, random moves with a win and full-board check
+// after each, clean up. Both versions play to the same end - the char**
+// board has no early draw, so the bitboard skips its dead-line rule here and
+// the games are the same length.
+static long long opGameBitboard(BenchCase *bc, long long n) {
+    long long sum = 0;
+    Board board;
+    int row, col;
+    for (long long i = 0; i < n; i++) {
+        boardInit(&board, bc->size, bc->players);
+        for (int turn = 0; ; turn++) {
+            int player = turn % bc->players;
+            boardRandomMove(&board, &bc->rng, &row, &col);
+            boardPlace(&board, row, col, player);
+            if (boardCheckWin(&board, player) || boardIsFull(&board)) break;
+        }
+        sum += board.moveCount;
+    }
+    return sum;
+}
+
+static long long opGameLegacy(BenchCase *bc, long long n) {
+    long long sum = 0;
+    int row, col;
+    for (long long i = 0; i < n; i++) {
+        char **board = legacyInitializeBoard(bc->size);
+        int turn = 0;
+        for (;; turn++) {
+            char symbol = playerToSymbol(turn % bc->players);
+            legacyComputerMove(board, bc->size, &bc->rng, &row, &col);
+            board[row][col] = symbol;
+            if (legacyCheckWin(board, bc->size, symbol) || legacyCheckDraw(board, bc->size)) break;
+        }
+        sum += turn;
+        legacyFreeBoard(board, bc->size);
+    }
+    return sum;
+}
+
+static int setupCase(BenchCase *bc, int size, int players, uint64_t seed) {
+    ComputerSettings settings;
+    computerDefaults(&settings);
+    settings.engine = ENGINE_RANDOM;
+    memset(&bc->computer, 0, sizeof(bc->computer));
+    if (!computerInit(&bc->computer, &settings)) return 0;
+    computerSeed(&bc->computer, seed);
+
+    bc->size = size;
+    bc->players = players;
+    rngSeed(&bc->rng, seed);
+    int cells = size * size;
+    for (int k = 0; k < BENCH_BOARDS; k++) {
+        // Between one and two thirds of the cells filled, nobody has won
+        Board *board = &bc->boards[k];
+        int row, col;
+        do {
+            int moves = cells / 3 + (int)rngBelow(&bc->rng, (uint64_t)(cells / 3 + 1));
+            boardInit(board, size, players);
+            for (int m = 0; m < moves && board->winner < 0; m++) {
+                boardRandomMove(board, &bc->rng, &row, &col);
+                boardPlace(board, row, col, m % players);
+            }
+        } while (board->winner >= 0 || boardIsFull(board));
+
+        bc->legacy[k] = legacyInitializeBoard(size);
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) bc->legacy[k][i][j] = boardCell(board, i, j);
+        }
+    }
+    for (int p = 0; p < BENCH_PROBES; p++) {
+        bc->probeRow[p] = (int)rngBelow(&bc->rng, (uint64_t)size + 2) - 1;  // -1 to size
+        bc->probeCol[p] = (int)rngBelow(&bc->rng, (uint64_t)size + 2) - 1;
+    }
+    return 1;
+}
+
+static void freeCase(BenchCase *bc) {
+    for (int k = 0; k < BENCH_BOARDS; k++) legacyFreeBoard(bc->legacy[k], bc->size);
+    computerFree(&bc->computer);
+}
+
+typedef struct {
+    const char *name;
+    BenchOp bitboard;
+    BenchOp legacy;
+    int isGame;         // Report games/sec and allocations per game
+} BenchPrimitive;
+
+static const BenchPrimitive primitives[] = {
+    { "initializeBoard", opInitBitboard,  opInitLegacy,  0 },
+    { "isValidMove",     opValidBitboard, opValidLegacy, 0 },
+    { "checkWin",        opWinBitboard,   opWinLegacy,   0 },
+    { "checkDraw",       opDrawBitboard,  opDrawLegacy,  0 },
+    { "computerMove",    opMoveBitboard,  opMoveLegacy,  0 },
+    { "randomGame",      opGameBitboard,  opGameLegacy,  1 },
+};
+
+// Run op for at least minSeconds; returns ns per iteration, allocations per iteration in *allocs
+static double timeOp(BenchOp op, BenchCase *bc, double minSeconds, double *allocs) {
+    long long n = 1;
+    for (;;) {
+        long long allocBefore = allocationCount();
+        double start = nowSeconds();
+        benchSink += op(bc, n);
+        double elapsed = nowSeconds() - start;
+        if (elapsed >= minSeconds || n >= (1LL << 40)) {
+            *allocs = (double)(allocationCount() - allocBefore) / (double)n;
+            return elapsed * 1e9 / (double)n;
+        }
+        // Aim a little past the budget so the next round is usually the last
+        n = (elapsed < minSeconds / 10) ? n * 10 : (long long)((double)n * minSeconds * 1.2 / elapsed) + 1;
+    }
+}
+
+static void benchPrimitives(double seconds, int json, uint64_t seed) {
+    static BenchCase bc;    // Too big for the stack
+    int rows = 0;
+
+    if (json) {
+        printf("[\n");
+    } else {
+        printf("Primitives (%.3f s per measurement, allocations %s)\n", seconds,
+               ALLOC_COUNTING ? "counted" : "not counted on this platform");
+        printf("%5s %7s %-16s %12s %12s %10s %14s %14s\n", "size", "players", "operation", "bitboard ns",
+               "char** ns", "speedup", "games/sec", "allocs/game");
+    }
+
+    for (int size = BOARD_MIN_SIZE; size <= BOARD_MAX_SIZE; size++) {
+        for (int players = 2; players <= BOARD_MAX_PLAYERS; players++) {
+            if (!setupCase(&bc, size, players, seed)) {
+                printf("Not enough memory for the computer player.\n");
+                return;
+            }
+            for (size_t p = 0; p < sizeof(primitives) / sizeof(primitives[0]); p++) {
+                const BenchPrimitive *prim = &primitives[p];
+                double newAllocs, oldAllocs;
+                double newNs = timeOp(prim->bitboard, &bc, seconds, &newAllocs);
+                double oldNs = timeOp(prim->legacy, &bc, seconds, &oldAllocs);
+
+                if (json) {
+                    const char *impls[2] = { "bitboard", "char**" };
+                    double ns[2] = { newNs, oldNs };
+                    double allocs[2] = { newAllocs, oldAllocs };
+                    for (int v = 0; v < 2; v++) {
+                        printf("%s  {\"size\": %d, \"players\": %d, \"operation\": \"%s\", \"board\": \"%s\", "
+                               "\"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, \"allocs_per_op\": ",
+                               rows++ > 0 ? ",\n" : "", size, players, prim->name, impls[v], ns[v], 1e9 / ns[v]);
+                        if (ALLOC_COUNTING) {
+                            printf("%.2f}", allocs[v]);
+                        } else {
+                            printf("null}");
+                        }
+                    }
+                } else if (prim->isGame) {
+                    char allocs[32];
+                    snprintf(allocs, sizeof(allocs), "%.1f / %.1f", newAllocs, oldAllocs);
+                    printf("%5d %7d %-16s %12.1f %12.1f %9.2fx %14.0f %14s\n", size, players, prim->name,
+                           newNs, oldNs, oldNs / newNs, 1e9 / newNs, allocs);
+                } else {
+                    printf("%5d %7d %-16s %12.1f %12.1f %9.2fx\n", size, players, prim->name, newNs, oldNs,
+                           oldNs / newNs);
+                }
+            }
+            freeCase(&bc);
+        }
+    }
+    if (json) printf("\n]\n");
+}
+
+int main(int argc, char *argv[]) {
+    int size = BOARD_MAX_SIZE;           // Largest supported board by default
+    int maxThreads = aiDefaultThreads();
+    double seconds = 0;                  // 0 = default for the chosen benchmark
+    int scaling = 0;
+    int json = 0;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scaling") == 0) {
+            scaling = 1;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            printf("Usage: %s [--json] [--time SECONDS] [--seed N]\n", argv[0]);
+            printf("       %s --scaling [--size N] [--threads MAX] [--time SECONDS]\n", argv[0]);
+            printf("  --time   Seconds per measurement (default 0.02), or per position with --scaling (default 1)\n");
+            return 1;
+        }
+    }
+    if (seconds == 0) seconds = scaling ? 1.0 : 0.02;
+    if (size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE || maxThreads < 1 || seconds <= 0) {
+        printf("Invalid benchmark settings.\n");
+        return 1;
+    }
+
+    if (scaling) {
+        benchSearchScaling(size, maxThreads, seconds);
+    } else {
+        benchPrimitives(seconds, json, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <stdlib.h>
+#include <string.h>
+#include "bigboard.h"
+
+#define BIG_INITIAL_SLOTS 64  // A few tiles before the first rehash
+
+// Row and column step of each direction: right, down, down-right, down-left
+static const int rowStep[BOARD_DIRECTIONS] = { 0, 1, 1, 1 };
+static const int colStep[BOARD_DIRECTIONS] = { 1, 0, 1, -1 };
+
+// Tile coordinate of a cell coordinate (floor division, also for negative cells)
+static inline int32_t tileOf(int cell) {
+    return (int32_t)((cell - (cell & (BIG_TILE - 1))) / BIG_TILE);
+}
+
+// Bit of a cell inside its tile
+static inline int bitOf(int row, int col) {
+    return ((row & (BIG_TILE - 1)) << BIG_TILE_BITS) | (col & (BIG_TILE - 1));
+}
+
+static size_t tileHash(const BigBoard *board, int32_t row, int32_t col) {
+    uint64_t key = ((uint64_t)(uint32_t)row << 32 | (uint32_t)col) * 0x9E3779B97F4A7C15ull;
+    return (size_t)(key ^ (key >> 29)) & (board->capacity - 1);
+}
+
+// Slot holding tile (row, col), or the free slot where it would go
+static BigTile *tileSlot(const BigBoard *board, int32_t row, int32_t col) {
+    size_t slot = tileHash(board, row, col);
+    for (;;) {
+        BigTile *tile = &board->tiles[slot];
+        if (!tile->used || (tile->row == row && tile->col == col)) return tile;
+        slot = (slot + 1) & (board->capacity - 1);  // Linear probing - the table is at most half full
+    }
+}
+
+static const BigTile *findTile(const BigBoard *board, int row, int col) {
+    const BigTile *tile = tileSlot(board, tileOf(row), tileOf(col));
+    return tile->used ? tile : NULL;
+}
+
+// Double the table; returns 0 if there is no memory (the old table is kept)
+static int growTable(BigBoard *board) {
+    size_t oldCapacity = board->capacity;
+    BigTile *old = board->tiles;
+    BigTile *tiles = (BigTile *)calloc(oldCapacity * 2, sizeof(BigTile));
+    if (tiles == NULL) return 0;
+
+    board->tiles = tiles;
+    board->capacity = oldCapacity * 2;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (old[i].used) *tileSlot(board, old[i].row, old[i].col) = old[i];
+    }
+    free(old);
+    return 1;
+}
+
+int bigInit(BigBoard *board, int size, int players, int winLength) {
+    memset(board, 0, sizeof(*board));
+    board->size = size;
+    board->players = players;
+    board->winLength = winLength;
+    board->winner = -1;
+    board->capacity = BIG_INITIAL_SLOTS;
+    board->tiles = (BigTile *)calloc(board->capacity, sizeof(BigTile));
+    return board->tiles != NULL;
+}
+
+void bigFree(BigBoard *board) {
+    free(board->tiles);
+    board->tiles = NULL;
+    board->capacity = board->tileCount = 0;
+}
+
+// Player owning (row, col), or -1 if it is empty or off the stored tiles
+static int cellOwner(const BigBoard *board, int row, int col) {
+    const BigTile *tile = findTile(board, row, col);
+    if (tile == NULL) return -1;
+    uint64_t bit = 1ull << bitOf(row, col);
+    for (int p = 0; p < board->players; p++) {
+        if (tile->marks[p] & bit) return p;
+    }
+    return -1;
+}
+
+char bigCell(const BigBoard *board, int row, int col) {
+    int owner = cellOwner(board, row, col);
+    return owner >= 0 ? playerToSymbol(owner) : EMPTY_CELL;
+}
+
+static int onBoard(const BigBoard *board, int row, int col) {
+    if (board->size == BIG_UNBOUNDED) {
+        return row >= -BIG_COORD_LIMIT && row <= BIG_COORD_LIMIT && col >= -BIG_COORD_LIMIT && col <= BIG_COORD_LIMIT;
+    }
+    return row >= 0 && row < board->size && col >= 0 && col < board->size;
+}
+
+int bigIsValidMove(const BigBoard *board, int row, int col) {
+    return onBoard(board, row, col) && cellOwner(board, row, col) < 0;
+}
+
+int bigRunLength(const BigBoard *board, int player, int row, int col, int dir) {
+    int run = 1;
+    for (int side = -1; side <= 1; side += 2) {
+        int dr = side * rowStep[dir], dc = side * colStep[dir];
+        int r = row + dr, c = col + dc;
+        while (run < board->winLength && onBoard(board, r, c) && cellOwner(board, r, c) == player) {
+            run++;
+            r += dr;
+            c += dc;
+        }
+    }
+    return run;
+}
+
+int bigPlace(BigBoard *board, int row, int col, int player) {
+    int32_t tileRow = tileOf(row), tileCol = tileOf(col);
+    BigTile *tile = tileSlot(board, tileRow, tileCol);
+
+    if (!tile->used) {
+        // A new tile: keep the table at most half full
+        if ((board->tileCount + 1) * 2 > board->capacity) {
+            if (!growTable(board)) return -1;
+            tile = tileSlot(board, tileRow, tileCol);
+        }
+        memset(tile, 0, sizeof(*tile));
+        tile->row = tileRow;
+        tile->col = tileCol;
+        tile->used = 1;
+        board->tileCount++;
+    }
+    tile->marks[player] |= 1ull << bitOf(row, col);
+
+    if (board->moveCount == 0) {
+        board->minRow = board->maxRow = row;
+        board->minCol = board->maxCol = col;
+    } else {
+        if (row < board->minRow) board->minRow = row;
+        if (row > board->maxRow) board->maxRow = row;
+        if (col < board->minCol) board->minCol = col;
+        if (col > board->maxCol) board->maxCol = col;
+    }
+    board->moveCount++;
+    board->lastRow = row;
+    board->lastCol = col;
+
+    for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+        if (bigRunLength(board, player, row, col, dir) >= board->winLength) {
+            board->winner = player;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int bigIsDraw(const BigBoard *board) {
+    if (board->winner >= 0 || board->size == BIG_UNBOUNDED) return 0;
+    return board->moveCount == (long long)board->size * board->size;
+}
+
+// Worth of playing (row, col) for player: 1 << 30 if it wins, a block of
+// the opponent who moves soonest next, otherwise the squared runs it makes
+// and breaks up (own runs count double)
+static int moveWorth(const BigBoard *board, int player, int row, int col) {
+    int worth = 0;
+    for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+        int run = bigRunLength(board, player, row, col, dir);
+        if (run >= board->winLength) return 1 << 30;
+        worth += 2 * run * run;
+    }
+    for (int d = 1; d < board->players; d++) {
+        int opponent = (player + d) % board->players;
+        for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+            int run = bigRunLength(board, opponent, row, col, dir);
+            if (run >= board->winLength) return (1 << 29) >> d;
+            worth += run * run;
+        }
+    }
+    return worth;
+}
+
+void bigComputerMove(const BigBoard *board, int player, int *row, int *col) {
+    if (board->moveCount == 0) {
+        *row = *col = (board->size == BIG_UNBOUNDED) ? 0 : board->size / 2;
+        return;
+    }
+
+    // Candidates: empty cells next to any mark, found tile by tile
+    int bestWorth = -1, bestDistance = 0;
+    for (size_t slot = 0; slot < board->capacity; slot++) {
+        const BigTile *tile = &board->tiles[slot];
+        if (!tile->used) continue;
+        uint64_t marked = tile->marks[0] | tile->marks[1] | tile->marks[2];
+
+        while (marked != 0) {
+            int bit = __builtin_ctzll(marked);
+            marked &= marked - 1;
+            int markRow = tile->row * BIG_TILE + (bit >> BIG_TILE_BITS);
+            int markCol = tile->col * BIG_TILE + (bit & (BIG_TILE - 1));
+
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    int r = markRow + dr, c = markCol + dc;
+                    if (!bigIsValidMove(board, r, c)) continue;
+
+                    // Ties go to the cell closest to the last move
+                    int worth = moveWorth(board, player, r, c);
+                    int distance = abs(r - board->lastRow) + abs(c - board->lastCol);
+                    if (worth > bestWorth || (worth == bestWorth && distance < bestDistance)) {
+                        bestWorth = worth;
+                        bestDistance = distance;
+                        *row = r;
+                        *col = c;
+                    }
+                }
+            }
+        }
+    }
+    if (bestWorth < 0) *row = *col = 0;  // Every neighbour taken: only possible on a full bounded board
+}
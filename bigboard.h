@@ -0,0 +1,73 @@
+#ifndef BIGBOARD_H
+#define BIGBOARD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "board.h"
+
+// Boards far beyond 10 x 10 - up to BIG_MAX_SIZE on a side, or with no edges
+// at all. Only the occupied part is stored: the plane is cut into 8 x 8 tiles
+// (one 64-bit word of marks per player, like the small Board's bitboards) and
+// a tile exists only once a mark lands in it, found through an open-addressing
+// hash table keyed by tile coordinates. Memory grows with the moves played,
+// never with the board area. Wins are K in a row (BIG_DEFAULT_WIN unless
+// given), checked only along the four directions through the last mark.
+// Part of the game core (gamecore.h).
+
+#define BIG_TILE_BITS 3
+#define BIG_TILE (1 << BIG_TILE_BITS)  // Cells per tile side
+#define BIG_MAX_SIZE 1000000           // Largest bounded board
+#define BIG_UNBOUNDED 0                // size of a board with no edges
+#define BIG_COORD_LIMIT 1000000000     // Largest |row| or |col| on an unbounded board
+#define BIG_DEFAULT_WIN 5              // Marks in a row that win unless set
+
+typedef struct {
+    int32_t row, col;                   // Tile coordinates (cell row / col >> BIG_TILE_BITS)
+    int used;                           // 0 = free hash slot
+    uint64_t marks[BOARD_MAX_PLAYERS];  // Bit (row % 8) * 8 + col % 8 per player
+} BigTile;
+
+typedef struct {
+    int size;              // Board is size x size, or BIG_UNBOUNDED
+    int players;           // 2 or 3
+    int winLength;         // Marks in a row that win
+    BigTile *tiles;        // Hash table of occupied tiles
+    size_t capacity;       // Slots in tiles (power of two)
+    size_t tileCount;      // Slots in use
+    long long moveCount;
+    int winner;            // Player who made winLength in a row, -1 if none
+    int lastRow, lastCol;  // Last mark placed (valid once moveCount > 0)
+    int minRow, maxRow, minCol, maxCol;  // Bounding box of all marks
+} BigBoard;
+
+// Set up an empty board (size BIG_UNBOUNDED for no edges). Cells are numbered
+// 0 to size - 1 on a bounded board and -BIG_COORD_LIMIT to BIG_COORD_LIMIT on
+// an unbounded one. Returns 0 if the table cannot be allocated.
+int bigInit(BigBoard *board, int size, int players, int winLength);
+void bigFree(BigBoard *board);
+
+// Symbol at (row, col): 'X', 'O', 'Z' or EMPTY_CELL
+char bigCell(const BigBoard *board, int row, int col);
+
+// 1 if (row, col) is on the board and empty
+int bigIsValidMove(const BigBoard *board, int row, int col);
+
+// Place player's mark (the move must be valid). Returns 1 if it makes
+// winLength in a row, 0 if not, -1 if no memory was left for a new tile
+// (the board is unchanged then).
+int bigPlace(BigBoard *board, int row, int col, int player);
+
+// 1 if a bounded board is full with no winner; an unbounded board never is
+int bigIsDraw(const BigBoard *board);
+
+// Length of player's run through (row, col) in direction dir (0 = right,
+// 1 = down, 2 = down-right, 3 = down-left), counting (row, col) itself as
+// player's. O(winLength) - the walk stops at winLength.
+int bigRunLength(const BigBoard *board, int player, int row, int col, int dir);
+
+// Greedy local move for player: win if possible, else block the first
+// opponent who could win, else extend the longest runs next to the existing
+// marks. Cost grows with the marks on the board, not with its area.
+void bigComputerMove(const BigBoard *board, int player, int *row, int *col);
+
+#endif
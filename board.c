@@ -0,0 +1,402 @@
+#include <string.h>
+#include "board.h"
+
+int symbolToPlayer(char symbol) {
+    switch (symbol) {
+        case 'X': return 0;
+        case 'O': return 1;
+        case 'Z': return 2;
+        default:  return -1;
+    }
+}
+
+char playerToSymbol(int player) {
+    return PLAYER_SYMBOLS[player];
+}
+
+uint64_t zobristKey(int player, int cell) {
+    // splitmix64 finalizer of (player, cell): a fixed pseudo-random key per
+    // pair without a table that would need initialising before use
+    uint64_t z = (uint64_t)(player * BOARD_MAX_CELLS + cell + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Row and column step of each direction: right, down, down-right, down-left
+static const int rowStep[BOARD_DIRECTIONS] = { 0, 1, 1, 1 };
+static const int colStep[BOARD_DIRECTIONS] = { 1, 0, 1, -1 };
+
+// Cell index step of direction dir
+static inline int cellStep(int size, int dir) {
+    return rowStep[dir] * size + colStep[dir];
+}
+
+// Move every bit n cells towards cell 0 / away from it (0 < n < 64)
+static inline BitBoard shiftDown(BitBoard b, int n) {
+    BitBoard r = {{ (b.w[0] >> n) | (b.w[1] << (64 - n)), b.w[1] >> n }};
+    return r;
+}
+
+static inline BitBoard shiftUp(BitBoard b, int n) {
+    BitBoard r = {{ b.w[0] << n, (b.w[1] << n) | (b.w[0] >> (64 - n)) }};
+    return r;
+}
+
+void boardInit(Board *board, int size, int players) {
+    boardInitRule(board, size, players, size);
+}
+
+void boardInitRule(Board *board, int size, int players, int winLength) {
+    memset(board, 0, sizeof(*board));
+    board->size = size;
+    board->cells = size * size;
+    board->players = players;
+    board->winLength = winLength;
+    board->winner = -1;
+
+    // Per-line counters only for the full-line rule
+    if (winLength == size) {
+        board->lineCount = 2 * size + 2;
+        board->liveLines = board->lineCount;
+    }
+
+    int reach = winLength - 1;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+                int endRow = row + reach * rowStep[dir], endCol = col + reach * colStep[dir];
+                if (endRow < size && endCol >= 0 && endCol < size) {
+                    bitSet(&board->windowStarts[dir], row * size + col);
+                }
+            }
+        }
+    }
+}
+
+// Add one mark of player to a line; returns 1 if that completes the line
+static int addLineMark(Board *board, int line, int player) {
+    unsigned char owners = board->lineOwners[line];
+    unsigned char bit = (unsigned char)(1u << player);
+
+    // A line dies the moment a second player puts a mark in it
+    if (owners != 0 && owners != bit && (owners & (owners - 1)) == 0) {
+        board->liveLines--;
+    }
+    board->lineOwners[line] = owners | bit;
+
+    return ++board->lineMarks[player][line] == board->size;
+}
+
+// Take one mark of player out of a line (undoes addLineMark). Branch-free:
+// in a search, whether this was player's last mark in the line is a coin toss.
+static void removeLineMark(Board *board, int line, int player) {
+    unsigned char gone = (unsigned char)((--board->lineMarks[player][line] == 0) << player);
+    unsigned char owners = board->lineOwners[line] & (unsigned char)~gone;
+    board->lineOwners[line] = owners;
+
+    // Back to a single player: the line is winnable again
+    board->liveLines += (gone != 0) & (owners != 0) & ((owners & (owners - 1)) == 0);
+}
+
+int boardSymmetryCell(int size, int symmetry, int cell) {
+    int row = cell / size, col = cell % size, last = size - 1;
+    switch (symmetry) {
+        case 1:  return col * size + (last - row);             // Rotate 90
+        case 2:  return (last - row) * size + (last - col);    // Rotate 180
+        case 3:  return (last - col) * size + row;             // Rotate 270
+        case 4:  return row * size + (last - col);             // Mirror left-right
+        case 5:  return (last - row) * size + col;             // Mirror top-bottom
+        case 6:  return col * size + row;                      // Main diagonal
+        case 7:  return (last - col) * size + (last - row);    // Anti-diagonal
+        default: return cell;
+    }
+}
+
+int boardSymmetryInverse(int symmetry) {
+    return (symmetry == 1 || symmetry == 3) ? 4 - symmetry : symmetry;  // Reflections undo themselves
+}
+
+void boardSymmetryHashes(const Board *board, uint64_t hashes[BOARD_SYMMETRIES]) {
+    for (int s = 0; s < BOARD_SYMMETRIES; s++) hashes[s] = 0;
+    for (int p = 0; p < board->players; p++) {
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            for (uint64_t bits = board->marks[p].w[w]; bits != 0; bits &= bits - 1) {
+                int cell = w * 64 + __builtin_ctzll(bits);
+                for (int s = 0; s < BOARD_SYMMETRIES; s++) {
+                    hashes[s] ^= zobristKey(p, boardSymmetryCell(board->size, s, cell));
+                }
+            }
+        }
+    }
+}
+
+uint64_t boardCanonicalHash(const Board *board, int *symmetry) {
+    uint64_t hashes[BOARD_SYMMETRIES];
+    boardSymmetryHashes(board, hashes);
+    int best = 0;
+    for (int s = 1; s < BOARD_SYMMETRIES; s++) {
+        if (hashes[s] < hashes[best]) best = s;
+    }
+    if (symmetry != NULL) *symmetry = best;
+    return hashes[best];
+}
+
+void boardTransform(const Board *board, int symmetry, Board *out) {
+    boardInitRule(out, board->size, board->players, board->winLength);
+    for (int p = 0; p < board->players; p++) {
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            for (uint64_t bits = board->marks[p].w[w]; bits != 0; bits &= bits - 1) {
+                int cell = boardSymmetryCell(board->size, symmetry, w * 64 + __builtin_ctzll(bits));
+                boardPlace(out, cell / board->size, cell % board->size, p);
+            }
+        }
+    }
+}
+
+char boardCell(const Board *board, int row, int col) {
+    int cell = row * board->size + col;
+    for (int p = 0; p < board->players; p++) {
+        if (bitTest(&board->marks[p], cell)) return playerToSymbol(p);
+    }
+    return EMPTY_CELL;
+}
+
+int boardIsValidMove(const Board *board, int row, int col) {
+    // Check if the position is within board boundaries
+    if (row < 0 || row >= board->size || col < 0 || col >= board->size) return 0;
+
+    // Check if the cell is already occupied
+    if (bitTest(&board->occupied, row * board->size + col)) return 0;
+
+    return 1;
+}
+
+// K in a row: 1 if the mark at (row, col) is part of winLength marks of
+// player in a line - walks out from the cell in the four directions only
+static int completesRow(const Board *board, int player, int row, int col) {
+    const BitBoard *mine = &board->marks[player];
+    int size = board->size, need = board->winLength;
+
+    for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+        int run = 1;
+        for (int side = -1; side <= 1; side += 2) {
+            int dr = side * rowStep[dir], dc = side * colStep[dir];
+            int r = row + dr, c = col + dc;
+            while (run < need && r >= 0 && r < size && c >= 0 && c < size && bitTest(mine, r * size + c)) {
+                run++;
+                r += dr;
+                c += dc;
+            }
+        }
+        if (run >= need) return 1;
+    }
+    return 0;
+}
+
+int boardPlace(Board *board, int row, int col, int player) {
+    int size = board->size;
+    int cell = row * size + col;
+    bitSet(&board->marks[player], cell);
+    bitSet(&board->occupied, cell);
+    board->moveCount++;
+    board->hash ^= zobristKey(player, cell);
+
+    int won;
+    if (board->winLength == size) {
+        // Count the mark in the (at most four) lines through this cell;
+        // a line is won as soon as its counter reaches size
+        won = addLineMark(board, row, player);                                       // Row
+        won |= addLineMark(board, size + col, player);                               // Column
+        if (row == col) won |= addLineMark(board, 2 * size, player);                 // Main diagonal
+        if (row + col == size - 1) won |= addLineMark(board, 2 * size + 1, player);  // Anti-diagonal
+    } else {
+        won = completesRow(board, player, row, col);
+    }
+
+    if (won && board->winner < 0) board->winner = player;
+    return won;
+}
+
+void boardUnplace(Board *board, int row, int col, int player) {
+    int size = board->size;
+    int cell = row * size + col;
+    bitClear(&board->marks[player], cell);
+    bitClear(&board->occupied, cell);
+    board->moveCount--;
+    board->hash ^= zobristKey(player, cell);
+
+    if (board->winLength == size) {
+        removeLineMark(board, row, player);
+        removeLineMark(board, size + col, player);
+        if (row == col) removeLineMark(board, 2 * size, player);
+        if (row + col == size - 1) removeLineMark(board, 2 * size + 1, player);
+    }
+
+    // Nothing is played after a win, so a winner can only come from this move
+    if (board->winner == player) board->winner = -1;
+}
+
+int boardCheckWin(const Board *board, int player) {
+    return board->winner == player;
+}
+
+int boardIsFull(const Board *board) {
+    return board->moveCount == board->cells;
+}
+
+// Windows of winLength cells in direction dir that hold none of the other
+// players' marks, as a bit at each window's start cell. With planes, also
+// how many of player's marks each window holds, as a 4-bit count per cell
+// (planes[b] = bit b of the count). Shift-and-AND over the whole board: a
+// window is open when every one of its cells is empty or player's.
+static BitBoard openWindows(const Board *board, int player, int dir, BitBoard planes[4]) {
+    int step = cellStep(board->size, dir);
+    BitBoard allowed, mine = board->marks[player], open;
+
+    for (int w = 0; w < BOARD_WORDS; w++) {
+        allowed.w[w] = ~(board->occupied.w[w] & ~mine.w[w]);
+        open.w[w] = board->windowStarts[dir].w[w] & allowed.w[w];
+        if (planes != NULL) {
+            planes[0].w[w] = mine.w[w];
+            planes[1].w[w] = planes[2].w[w] = planes[3].w[w] = 0;
+        }
+    }
+    for (int i = 1; i < board->winLength; i++) {
+        allowed = shiftDown(allowed, step);
+        if (planes != NULL) mine = shiftDown(mine, step);
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            open.w[w] &= allowed.w[w];
+            if (planes == NULL) continue;
+            // Ripple-carry add of one bit to the counters
+            uint64_t carry = mine.w[w];
+            for (int b = 0; b < 4 && carry != 0; b++) {
+                uint64_t next = planes[b].w[w] & carry;
+                planes[b].w[w] ^= carry;
+                carry = next;
+            }
+        }
+    }
+    return open;
+}
+
+// Cells (window starts) whose 4-bit count in planes equals value
+static inline uint64_t countEquals(const BitBoard planes[4], int w, int value) {
+    uint64_t match = ~(uint64_t)0;
+    for (int b = 0; b < 4; b++) {
+        match &= ((value >> b) & 1) ? planes[b].w[w] : ~planes[b].w[w];
+    }
+    return match;
+}
+
+int boardIsDraw(const Board *board) {
+    if (board->winner >= 0) return 0;
+    if (board->moveCount == board->cells) return 1;
+    if (board->winLength == board->size) return board->liveLines == 0;
+
+    // K in a row: a draw once no window is open to anyone
+    for (int p = 0; p < board->players; p++) {
+        for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+            BitBoard open = openWindows(board, p, dir, NULL);
+            if ((open.w[0] | open.w[1]) != 0) return 0;
+        }
+    }
+    return 1;
+}
+
+BitBoard boardThreats(const Board *board, int player) {
+    BitBoard threats = {{ 0, 0 }};
+    BitBoard planes[4];
+
+    for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+        BitBoard open = openWindows(board, player, dir, planes);
+        BitBoard ready;  // Open windows one mark short
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            ready.w[w] = open.w[w] & countEquals(planes, w, board->winLength - 1);
+        }
+        if ((ready.w[0] | ready.w[1]) == 0) continue;
+
+        // The missing mark is the window's one empty cell
+        int step = cellStep(board->size, dir);
+        for (int i = 0; i < board->winLength; i++) {
+            for (int w = 0; w < BOARD_WORDS; w++) threats.w[w] |= ready.w[w] & ~board->occupied.w[w];
+            ready = shiftUp(ready, step);
+        }
+    }
+    return threats;
+}
+
+int boardWindowCounts(const Board *board, int player, int counts[BOARD_MAX_SIZE + 1]) {
+    BitBoard planes[4];
+    int total = 0;
+
+    for (int j = 0; j <= board->winLength; j++) counts[j] = 0;
+    for (int dir = 0; dir < BOARD_DIRECTIONS; dir++) {
+        BitBoard open = openWindows(board, player, dir, planes);
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            if (open.w[w] == 0) continue;
+            total += bitCount64(open.w[w]);
+            for (int j = 0; j <= board->winLength; j++) {
+                counts[j] += bitCount64(open.w[w] & countEquals(planes, w, j));
+            }
+        }
+    }
+    return total;
+}
+
+void boardRandomMove(const Board *board, Rng *rng, int *row, int *col) {
+    int k = (int)rngBelow(rng, (uint32_t)(board->cells - board->moveCount));
+    int cell;
+
+    // Free cells are the clear bits of occupied inside the board; the first
+    // word's popcount tells which word holds the k-th one
+    uint64_t free0 = ~board->occupied.w[0];
+    if (board->cells < 64) free0 &= ((uint64_t)1 << board->cells) - 1;
+    int count0 = bitCount64(free0);
+    if (k < count0) {
+        cell = bitSelect64(free0, k);
+    } else {
+        uint64_t free1 = ~board->occupied.w[1] & (((uint64_t)1 << (board->cells - 64)) - 1);
+        cell = 64 + bitSelect64(free1, k - count0);
+    }
+
+    // Multiply by a rounded-up reciprocal instead of dividing - exact for
+    // every cell of every supported size
+    static const uint32_t rowReciprocal[BOARD_MAX_SIZE + 1] = {
+        0, 0, 0, 21846, 16384, 13108, 10923, 9363, 8192, 7282, 6554
+    };
+    *row = (int)(((uint32_t)cell * rowReciprocal[board->size]) >> 16);
+    *col = cell - *row * board->size;
+}
+
+void gameStateInit(GameState *state, int size, int players, int winLength) {
+    boardInitRule(&state->board, size, players, winLength);
+    state->moveTotal = 0;
+}
+
+int gameStateMake(GameState *state, int row, int col) {
+    Board *board = &state->board;
+    int count = board->moveCount;
+    unsigned char cell = (unsigned char)(row * board->size + col);
+    if (count >= state->moveTotal || state->moves[count] != cell) state->moveTotal = count + 1;
+    state->moves[count] = cell;
+    return boardPlace(board, row, col, count % board->players);
+}
+
+int gameStateUnmake(GameState *state) {
+    Board *board = &state->board;
+    if (board->moveCount == 0) return 0;
+    int count = board->moveCount - 1;
+    int cell = state->moves[count];
+    boardUnplace(board, cell / board->size, cell % board->size, count % board->players);
+    return 1;
+}
+
+int gameStateRedo(GameState *state) {
+    Board *board = &state->board;
+    int count = board->moveCount;
+    if (count >= state->moveTotal) return 0;
+    int cell = state->moves[count];
+    boardPlace(board, cell / board->size, cell % board->size, count % board->players);
+    return 1;
+}
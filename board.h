@@ -0,0 +1,213 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+#include "rng.h"
+
+// Shared bitboard engine used by every game variant.
+// The whole game state lives in one contiguous struct - no per-row malloc.
+
+#define BOARD_MIN_SIZE 3     // Smallest supported board (3 x 3)
+#define BOARD_MAX_SIZE 10    // Largest supported board (10 x 10)
+#define BOARD_MAX_CELLS (BOARD_MAX_SIZE * BOARD_MAX_SIZE)
+#define BOARD_MAX_PLAYERS 3  // X, O and Z
+#define BOARD_MAX_LINES (2 * BOARD_MAX_SIZE + 2)  // rows + columns + 2 diagonals
+#define BOARD_WORDS 2        // 100 cells fit in two 64-bit words
+#define BOARD_DIRECTIONS 4   // Row, column, diagonal and anti-diagonal
+#define BOARD_SYMMETRIES 8   // Rotations and reflections of the square (dihedral group D4)
+
+#define EMPTY_CELL ' '       // Symbol shown for a cell nobody has played
+#define PLAYER_SYMBOLS "XOZ" // Symbol of player 0, 1 and 2
+
+// One bit per cell: cell (row, col) is bit row * size + col
+typedef struct {
+    uint64_t w[BOARD_WORDS];
+} BitBoard;
+
+// Winning rule: a full row, column or main diagonal (winLength == size), or
+// "K in a row" - any winLength marks in a line in one of the four directions
+// (e.g. 5 in a row on 10 x 10). The full-line rule keeps per-line counters
+// below; for K in a row, boardPlace looks only along the four directions
+// through the new mark, and the whole-board questions (threats, open
+// windows, draws) are answered with shift-and-AND kernels over the bitboards.
+typedef struct {
+    int size;                             // Board is size x size
+    int cells;                            // size * size
+    int players;                          // Number of players taking turns (2 or 3)
+    int winLength;                        // Marks in a row that win (3 to size)
+    BitBoard marks[BOARD_MAX_PLAYERS];    // Cells owned by each player
+    BitBoard occupied;                    // Union of all marks
+    int moveCount;                        // Number of occupied cells
+    int lineCount;                        // 2 * size + 2
+    int liveLines;                        // Lines still winnable (marks from at most one player)
+    // Marks each player has in every line: rows 0..size-1, columns
+    // size..2*size-1, then the main diagonal and the anti-diagonal
+    unsigned char lineMarks[BOARD_MAX_PLAYERS][BOARD_MAX_LINES];
+    unsigned char lineOwners[BOARD_MAX_LINES];  // Bit p set once player p has a mark in the line
+    int winner;                           // Player who completed a line, -1 if none
+    uint64_t hash;                        // Zobrist hash of the marks on the board
+    // Cells where a winLength window starts in each direction (right, down,
+    // down-right, down-left) without leaving the board
+    BitBoard windowStarts[BOARD_DIRECTIONS];
+} Board;
+
+// Bit helpers - cell index is row * size + col (0 to 99)
+static inline int bitTest(const BitBoard *b, int cell) {
+    return (int)((b->w[cell >> 6] >> (cell & 63)) & 1u);
+}
+
+static inline void bitSet(BitBoard *b, int cell) {
+    b->w[cell >> 6] |= (uint64_t)1 << (cell & 63);
+}
+
+static inline void bitClear(BitBoard *b, int cell) {
+    b->w[cell >> 6] &= ~((uint64_t)1 << (cell & 63));
+}
+
+// Number of set bits in x (hardware popcount when the target has one)
+static inline int bitCount64(uint64_t x) {
+#if defined(__POPCNT__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Number of bytes of running (each below 128) that are at most k
+static inline int bytesAtMost(uint64_t running, int k) {
+    const uint64_t ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+    uint64_t above = ((running | highs) - (uint64_t)(k + 1) * ones) & highs;  // Bytes > k
+    return 8 - (int)(((above >> 7) * ones) >> 56);
+}
+
+// Position of the k-th (0-based) set bit of x - x must have more than k bits set.
+// Branch-free: running per-byte popcounts pick the byte, then the byte's bits
+// are spread one per byte and the same trick picks the bit inside it.
+static inline int bitSelect64(uint64_t x, int k) {
+    const uint64_t ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+    uint64_t bytes = x - ((x >> 1) & 0x5555555555555555ull);
+    bytes = (bytes & 0x3333333333333333ull) + ((bytes >> 2) & 0x3333333333333333ull);
+    bytes = (bytes + (bytes >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    uint64_t running = bytes * ones;  // Byte i = bits set in bytes 0..i
+
+    int shift = 8 * bytesAtMost(running, k);
+    k -= (int)(((running << 8) >> shift) & 0xFF);
+
+    uint64_t byte = (x >> shift) & 0xFF;
+    uint64_t spread = (byte * ones) & 0x8040201008040201ull;  // Bit i of byte in byte i
+    uint64_t bits = ((spread + 0x7F7F7F7F7F7F7F7Full) & highs) >> 7;  // ... as 0 or 1
+    return shift + bytesAtMost(bits * ones, k);
+}
+
+// Symbol conversion: 'X' -> 0, 'O' -> 1, 'Z' -> 2 (-1 for anything else)
+int symbolToPlayer(char symbol);
+char playerToSymbol(int player);
+
+// Zobrist key for player owning cell - XOR-ed into Board.hash by boardPlace
+uint64_t zobristKey(int player, int cell);
+
+// Set up an empty size x size board for the given number of players (full-line rule)
+void boardInit(Board *board, int size, int players);
+
+// The same with winLength in a row to win (winLength == size is the full-line rule)
+void boardInitRule(Board *board, int size, int players, int winLength);
+
+// Symbol at (row, col): 'X', 'O', 'Z' or EMPTY_CELL
+char boardCell(const Board *board, int row, int col);
+
+// 1 if (row, col) is on the board and empty, otherwise 0
+int boardIsValidMove(const Board *board, int row, int col);
+
+// Place a mark for player (0-based index) - the move must be valid.
+// Only the lines through (row, col) are updated; returns 1 if this move wins.
+int boardPlace(Board *board, int row, int col, int player);
+
+// Take back the last mark placed, at (row, col) by player: the exact inverse
+// of boardPlace - bits, counters, live lines, winner and hash come back to
+// what they were, touching only the lines through the cell. Marks must be
+// taken back in the reverse order they were placed.
+void boardUnplace(Board *board, int row, int col, int player);
+
+// 1 if player has won (O(1) - tracked by boardPlace)
+int boardCheckWin(const Board *board, int player);
+
+// 1 if every cell is occupied (O(1) - occupied-cell counter)
+int boardIsFull(const Board *board);
+
+// 1 if nobody has won and nobody can win any more: the board is full or
+// every line (every window of winLength cells) already holds marks from two
+// different players. O(1) for the full-line rule; one bitboard kernel pass
+// for K in a row.
+int boardIsDraw(const Board *board);
+
+// Cells where player would complete winLength in a row by playing now,
+// found for the whole board at once with the window kernel
+BitBoard boardThreats(const Board *board, int player);
+
+// How the windows of winLength cells still open to player (holding none of
+// the other players' marks) are filled: counts[j] = open windows holding
+// exactly j of player's marks, for j = 0 to winLength. Returns the number of
+// open windows.
+int boardWindowCounts(const Board *board, int player, int counts[BOARD_MAX_SIZE + 1]);
+
+// Symmetry: the 8 ways to rotate or reflect the board map every line (and
+// every K-in-a-row window) onto another, so positions that are rotations or
+// mirror images of each other have the same value and best moves. Symmetry
+// 0 is the identity, 1-3 rotate by 90, 180 and 270 degrees clockwise, 4 and
+// 5 mirror left-right and top-bottom, 6 and 7 reflect in the two diagonals.
+
+// Cell that cell (row * size + col) moves to under symmetry
+int boardSymmetryCell(int size, int symmetry, int cell);
+
+// The symmetry that undoes symmetry
+int boardSymmetryInverse(int symmetry);
+
+// Zobrist hash of board under each symmetry (hashes[0] == board->hash)
+void boardSymmetryHashes(const Board *board, uint64_t hashes[BOARD_SYMMETRIES]);
+
+// Hash shared by all symmetric versions of the position: the smallest of the
+// eight. *symmetry (if not NULL) is the symmetry that takes board to the
+// canonical version, so a move m found there is boardSymmetryCell(size,
+// boardSymmetryInverse(*symmetry), m) here.
+uint64_t boardCanonicalHash(const Board *board, int *symmetry);
+
+// Copy board under symmetry (same rule, winner and move count)
+void boardTransform(const Board *board, int symmetry, Board *out);
+
+// Pick a uniformly random empty cell using rng (board must not be full).
+// Constant time: one random number, then the cell is selected straight from
+// the free bits of the bitboard - no retries as the board fills up.
+void boardRandomMove(const Board *board, Rng *rng, int *row, int *col);
+
+// A game in progress: the board plus a fixed-capacity stack of its moves, so
+// moves can be taken back and played again with boardPlace/boardUnplace -
+// no board copies, no replay from the start, no allocation. Moves taken back
+// stay above the top of the stack for redo until a different move is made.
+// Players move in turn: the side to move is moveCount % players.
+typedef struct {
+    Board board;
+    unsigned char moves[BOARD_MAX_CELLS];  // Cell of every move; the first board.moveCount are on the board
+    int moveTotal;                         // Moves on the stack, made or taken back (>= board.moveCount)
+} GameState;
+
+void gameStateInit(GameState *state, int size, int players, int winLength);
+
+// Seat to move
+static inline int gameStateToMove(const GameState *state) {
+    return state->board.moveCount % state->board.players;
+}
+
+// Play (row, col) for the seat to move - the move must be valid. Playing
+// anything but the next redo move discards the redo moves. Returns 1 if it wins.
+int gameStateMake(GameState *state, int row, int col);
+
+// Take back the last move; returns 0 if there is none
+int gameStateUnmake(GameState *state);
+
+// Play the last move taken back again; returns 0 if there is none
+int gameStateRedo(GameState *state);
+
+#endif
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "book.h"
+#include "archive.h"
+
+#define KEY_MASK (~(uint64_t)0xFFFF)  // Part of the key kept in a slot
+#define NO_CELL 127
+#define BOOK_INITIAL_BITS 10
+
+static uint64_t getU64(const unsigned char *in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) value = value << 8 | in[i];
+    return value;
+}
+
+static void putU64(unsigned char *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = (unsigned char)(value >> (8 * i));
+}
+
+uint64_t bookKey(const Board *board, int player, int *symmetry) {
+    uint64_t key = boardCanonicalHash(board, symmetry);
+    // As in the minimax table: 2-player values are the same for either side
+    return (board->players > 2) ? key ^ zobristKey(player, BOARD_MAX_CELLS) : key;
+}
+
+uint64_t bookEntry(uint64_t key, BookOutcome outcome, int plies, int move) {
+    if (move < 0) move = NO_CELL;
+    return (key & KEY_MASK) | (uint64_t)outcome << 14 | (uint64_t)(plies & 0x7F) << 7 | (uint64_t)move;
+}
+
+int bookOpen(Book *book, const char *path) {
+    memset(book, 0, sizeof(*book));
+    if (!archiveMapFile(path, &book->map, &book->mapSize)) return 0;
+
+    const unsigned char *data = (const unsigned char *)book->map;
+    size_t size = book->mapSize;
+    int count = (size >= BOOK_HEADER) ? (data[6] | data[7] << 8) : 0;
+    if (size < BOOK_HEADER || memcmp(data, BOOK_MAGIC, 4) != 0 || (data[4] | data[5] << 8) > BOOK_VERSION ||
+        count > BOOK_MAX_SECTIONS || size < BOOK_HEADER + (size_t)count * BOOK_SECTION_BYTES) {
+        bookClose(book);
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const unsigned char *entry = data + BOOK_HEADER + (size_t)i * BOOK_SECTION_BYTES;
+        BookSection *section = &book->sections[i];
+        uint64_t offset = getU64(entry + 8);
+        section->size = entry[0];
+        section->players = entry[1];
+        section->winLength = entry[2];
+        section->solved = entry[3];
+        section->slotBits = entry[4];
+        section->entries = (long long)getU64(entry + 16);
+        if (section->slotBits > 40 || offset > size || (size - offset) >> 3 < ((uint64_t)1 << section->slotBits)) {
+            bookClose(book);  // Table runs past the end of the file
+            return 0;
+        }
+        section->slots = data + offset;
+    }
+    book->sectionCount = count;
+    return 1;
+}
+
+void bookClose(Book *book) {
+    archiveUnmapFile(book->map, book->mapSize);
+    book->map = NULL;
+    book->mapSize = 0;
+    book->sectionCount = 0;
+}
+
+int bookLookup(const Book *book, const Board *board, int player, BookMove *move) {
+    const BookSection *section = NULL;
+    for (int i = 0; i < book->sectionCount && section == NULL; i++) {
+        const BookSection *s = &book->sections[i];
+        if (s->size == board->size && s->players == board->players && s->winLength == board->winLength) section = s;
+    }
+    if (section == NULL) return 0;
+
+    int symmetry;
+    uint64_t key = bookKey(board, player, &symmetry);
+    uint64_t mask = ((uint64_t)1 << section->slotBits) - 1;
+    for (uint64_t slot = (key >> 16) & mask; ; slot = (slot + 1) & mask) {
+        uint64_t entry = getU64(section->slots + 8 * slot);
+        if (entry == 0) return 0;
+        if ((entry & KEY_MASK) != (key & KEY_MASK)) continue;
+
+        int cell = (int)(entry & 0x7F);
+        if (cell == NO_CELL || cell >= board->cells) return 0;
+        cell = boardSymmetryCell(board->size, boardSymmetryInverse(symmetry), cell);
+        if (bitTest(&board->occupied, cell)) return 0;  // Key collision - never trust it
+
+        move->row = cell / board->size;
+        move->col = cell % board->size;
+        move->outcome = (BookOutcome)((entry >> 14) & 3);
+        move->plies = (int)((entry >> 7) & 0x7F);
+        move->solved = section->solved;
+        return 1;
+    }
+}
+
+int bookTableInit(BookTable *table, int size, int players, int winLength, int solved) {
+    memset(table, 0, sizeof(*table));
+    table->size = size;
+    table->players = players;
+    table->winLength = winLength;
+    table->solved = solved;
+    table->slotBits = BOOK_INITIAL_BITS;
+    table->slots = (uint64_t *)calloc((size_t)1 << table->slotBits, sizeof(uint64_t));
+    return table->slots != NULL;
+}
+
+void bookTableFree(BookTable *table) {
+    free(table->slots);
+    table->slots = NULL;
+}
+
+// Slot holding key, or the empty slot where it goes. The slot number comes
+// from the stored part of the key, so an entry alone says where it belongs.
+static uint64_t *tableSlot(uint64_t *slots, int slotBits, uint64_t key) {
+    uint64_t mask = ((uint64_t)1 << slotBits) - 1;
+    uint64_t slot = (key >> 16) & mask;
+    while (slots[slot] != 0 && (slots[slot] & KEY_MASK) != (key & KEY_MASK)) slot = (slot + 1) & mask;
+    return &slots[slot];
+}
+
+int bookTableAdd(BookTable *table, uint64_t key, uint64_t entry) {
+    if ((table->entries + 1) * 2 > ((long long)1 << table->slotBits)) {
+        uint64_t *slots = (uint64_t *)calloc((size_t)1 << (table->slotBits + 1), sizeof(uint64_t));
+        if (slots == NULL) return 0;
+        for (size_t i = 0; i < (size_t)1 << table->slotBits; i++) {
+            if (table->slots[i] != 0) *tableSlot(slots, table->slotBits + 1, table->slots[i]) = table->slots[i];
+        }
+        free(table->slots);
+        table->slots = slots;
+        table->slotBits++;
+    }
+    uint64_t *slot = tableSlot(table->slots, table->slotBits, key);
+    if (*slot == 0) table->entries++;
+    *slot = entry;
+    return 1;
+}
+
+int bookTableHas(const BookTable *table, uint64_t key) {
+    return *tableSlot(table->slots, table->slotBits, key) != 0;
+}
+
+int bookWrite(const char *path, const BookTable *tables, int count) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return 0;
+
+    unsigned char header[BOOK_HEADER] = { 0 };
+    memcpy(header, BOOK_MAGIC, 4);
+    header[4] = (unsigned char)BOOK_VERSION;
+    header[5] = (unsigned char)(BOOK_VERSION >> 8);
+    header[6] = (unsigned char)count;
+    header[7] = (unsigned char)(count >> 8);
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    uint64_t offset = BOOK_HEADER + (uint64_t)count * BOOK_SECTION_BYTES;
+    for (int i = 0; i < count && ok; i++) {
+        unsigned char entry[BOOK_SECTION_BYTES] = { 0 };
+        entry[0] = (unsigned char)tables[i].size;
+        entry[1] = (unsigned char)tables[i].players;
+        entry[2] = (unsigned char)tables[i].winLength;
+        entry[3] = (unsigned char)tables[i].solved;
+        entry[4] = (unsigned char)tables[i].slotBits;
+        putU64(entry + 8, offset);
+        putU64(entry + 16, (uint64_t)tables[i].entries);
+        ok = fwrite(entry, 1, sizeof(entry), file) == sizeof(entry);
+        offset += (uint64_t)8 << tables[i].slotBits;
+    }
+
+    unsigned char buffer[8 * 1024];
+    for (int i = 0; i < count && ok; i++) {
+        size_t slots = (size_t)1 << tables[i].slotBits;
+        for (size_t s = 0; s < slots && ok; s += sizeof(buffer) / 8) {
+            size_t n = slots - s < sizeof(buffer) / 8 ? slots - s : sizeof(buffer) / 8;
+            for (size_t j = 0; j < n; j++) putU64(buffer + 8 * j, tables[i].slots[s + j]);
+            ok = fwrite(buffer, 8, n, file) == n;
+        }
+    }
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
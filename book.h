@@ -0,0 +1,103 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+// Precomputed moves: perfect play for the boards small enough to solve
+// outright (the tablebase) and searched moves for the first plies of larger
+// boards (the opening book), in one file written by bookgen. The file is
+// memory-mapped once; a lookup canonicalises the position (boardCanonicalHash,
+// so one entry covers all 8 symmetric positions) and probes one hash table
+// slot or a few - no search.
+//
+// File layout (all numbers little-endian):
+//   Header, 16 bytes:  "TTTS", uint16 version, uint16 section count, 8 reserved bytes (0)
+//   Section directory, 24 bytes each:
+//                      uint8 size, uint8 players, uint8 win length, uint8 kind
+//                      (1 = solved, 0 = opening book), uint8 slot bits,
+//                      3 reserved bytes, uint64 file offset, uint64 entries
+//   Then each section's table: 2^slot bits uint64 slots, 0 = empty, else
+//     bits 16-63  top 48 bits of the position key (slot = those bits & mask, linear probing)
+//     bits 14-15  BookOutcome for the player to move
+//     bits  7-13  plies to the end of the game under perfect play (solved sections)
+//     bits  0-6   best move as a cell of the canonical position
+
+#define BOOK_MAGIC "TTTS"
+#define BOOK_VERSION 1
+#define BOOK_HEADER 16
+#define BOOK_SECTION_BYTES 24
+#define BOOK_MAX_SECTIONS 64
+#define BOOK_DEFAULT_PATH "tictactoe.book"  // Loaded by the computer player when present
+
+typedef enum {
+    BOOK_UNKNOWN,  // Opening book move: searched, not solved
+    BOOK_WIN,      // The player to move wins with perfect play
+    BOOK_DRAW,
+    BOOK_LOSS      // ... loses (the move delays it longest)
+} BookOutcome;
+
+// One table of a book file
+typedef struct {
+    int size, players, winLength;
+    int solved;                  // 1 = every position the computer can face, with perfect play
+    int slotBits;
+    long long entries;
+    const unsigned char *slots;  // Inside the mapping
+} BookSection;
+
+typedef struct {
+    int sectionCount;
+    BookSection sections[BOOK_MAX_SECTIONS];
+    void *map;
+    size_t mapSize;
+} Book;
+
+// The answer for one position
+typedef struct {
+    int row, col;
+    BookOutcome outcome;
+    int plies;        // Plies to the end under perfect play (solved positions only)
+    int solved;
+} BookMove;
+
+// Map path and check it; returns 0 if it is missing or not a book file
+int bookOpen(Book *book, const char *path);
+void bookClose(Book *book);
+
+// Look up the move for player on board; returns 0 if the book does not know
+// the position
+int bookLookup(const Book *book, const Board *board, int player, BookMove *move);
+
+// Key of the position in a book table: the canonical hash, mixed with the
+// player to move in 3-player games (where values depend on who is asking).
+// *symmetry takes board to the canonical position.
+uint64_t bookKey(const Board *board, int player, int *symmetry);
+
+// Slot value for a position key; move is a cell of the canonical position
+uint64_t bookEntry(uint64_t key, BookOutcome outcome, int plies, int move);
+
+// A table being built in memory (bookgen)
+typedef struct {
+    int size, players, winLength, solved;
+    int slotBits;
+    long long entries;
+    uint64_t *slots;
+} BookTable;
+
+// Returns 0 if out of memory
+int bookTableInit(BookTable *table, int size, int players, int winLength, int solved);
+void bookTableFree(BookTable *table);
+
+// Add or replace the entry for key; grows the table to stay at most half
+// full. Returns 0 if out of memory.
+int bookTableAdd(BookTable *table, uint64_t key, uint64_t entry);
+
+// 1 if the table has an entry for key
+int bookTableHas(const BookTable *table, uint64_t key);
+
+// Write the tables as one book file; returns 0 on a write error
+int bookWrite(const char *path, const BookTable *tables, int count);
+
+#endif
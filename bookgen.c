@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "book.h"
+#include "ai.h"
+#include "timer.h"
+
+// Writes the computer player's book file (book.h). Small boards are solved
+// outright - every position, with the 2-player value for the side to move or
+// the 3-player value for one seat against the other two, as the minimax
+// player scores them - and the table keeps each position the computer can
+// face when it follows the solution, whichever seat it plays. Larger boards
+// get an opening book: a fixed-depth search of every position in the first
+// few plies. Symmetric positions share one entry throughout.
+
+#define SOLVE_WIN 100           // Score of a win on the next move is SOLVE_WIN - 1
+#define MAX_SOLVE_CELLS 16      // 4 x 4 - larger boards are not solvable this way
+#define DEFAULT_SOLVE "3:2,3:3,4:2"
+#define DEFAULT_BOOK_PLIES 2
+#define DEFAULT_BOOK_DEPTH 4
+
+// Exact values of solved positions, keyed by book key
+typedef struct {
+    uint64_t *keys;
+    short *scores;
+    unsigned char *moves;  // Best move in the canonical position
+    size_t mask;
+    size_t count;
+} Memo;
+
+typedef struct {
+    int size;
+    Memo memo;
+    Memo visited;          // Positions already added while collecting
+    unsigned char symmetryCell[BOARD_SYMMETRIES][BOARD_MAX_CELLS];
+    uint64_t symmetryKey[BOARD_SYMMETRIES][BOARD_MAX_PLAYERS][BOARD_MAX_CELLS];
+} Solver;
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --out FILE        Book file to write (default: %s)\n", BOOK_DEFAULT_PATH);
+    printf("  --solve LIST      Boards to solve as SIZE:PLAYERS[:WIN], e.g. 4:2:3 (default: %s, none = skip)\n",
+           DEFAULT_SOLVE);
+    printf("  --book A-B        Board sizes for the opening book (default: 5-%d, none = skip)\n", BOARD_MAX_SIZE);
+    printf("  --book-plies N    Plies covered by the opening book (default: %d)\n", DEFAULT_BOOK_PLIES);
+    printf("  --book-depth D    Search depth for opening book moves (default: %d)\n", DEFAULT_BOOK_DEPTH);
+    printf("  --threads N       Search threads for the opening book (default: 1, the same book every run)\n");
+}
+
+static int memoInit(Memo *memo, size_t slots) {
+    memo->mask = slots - 1;
+    memo->count = 0;
+    memo->keys = (uint64_t *)calloc(slots, sizeof(uint64_t));
+    memo->scores = (short *)calloc(slots, sizeof(short));
+    memo->moves = (unsigned char *)calloc(slots, 1);
+    return memo->keys != NULL && memo->scores != NULL && memo->moves != NULL;
+}
+
+static void memoFree(Memo *memo) {
+    free(memo->keys);
+    free(memo->scores);
+    free(memo->moves);
+    memset(memo, 0, sizeof(*memo));
+}
+
+// Slot of key (key 0 is stored as 1 - an empty slot holds 0)
+static size_t memoSlot(const Memo *memo, uint64_t key) {
+    if (key == 0) key = 1;
+    size_t slot = (size_t)(key ^ (key >> 32)) & memo->mask;
+    while (memo->keys[slot] != 0 && memo->keys[slot] != key) slot = (slot + 1) & memo->mask;
+    return slot;
+}
+
+static int memoFind(const Memo *memo, uint64_t key, int *score, int *move) {
+    size_t slot = memoSlot(memo, key);
+    if (memo->keys[slot] == 0) return 0;
+    if (score != NULL) *score = memo->scores[slot];
+    if (move != NULL) *move = memo->moves[slot];
+    return 1;
+}
+
+static int memoAdd(Memo *memo, uint64_t key, int score, int move) {
+    if ((memo->count + 1) * 2 > memo->mask + 1) {
+        Memo bigger;
+        if (!memoInit(&bigger, (memo->mask + 1) * 2)) {
+            memoFree(&bigger);
+            return 0;
+        }
+        for (size_t i = 0; i <= memo->mask; i++) {
+            if (memo->keys[i] == 0) continue;
+            size_t slot = memoSlot(&bigger, memo->keys[i]);
+            bigger.keys[slot] = memo->keys[i];
+            bigger.scores[slot] = memo->scores[i];
+            bigger.moves[slot] = memo->moves[i];
+        }
+        bigger.count = memo->count;
+        memoFree(memo);
+        *memo = bigger;
+    }
+    size_t slot = memoSlot(memo, key);
+    if (memo->keys[slot] == 0) memo->count++;
+    memo->keys[slot] = key ? key : 1;
+    memo->scores[slot] = (short)score;
+    memo->moves[slot] = (unsigned char)move;
+    return 1;
+}
+
+static void solverTables(Solver *solver, int size, int players) {
+    solver->size = size;
+    for (int s = 0; s < BOARD_SYMMETRIES; s++) {
+        for (int cell = 0; cell < size * size; cell++) {
+            int image = boardSymmetryCell(size, s, cell);
+            solver->symmetryCell[s][cell] = (unsigned char)image;
+            for (int p = 0; p < players; p++) solver->symmetryKey[s][p][cell] = zobristKey(p, image);
+        }
+    }
+}
+
+// Book key of a position from its hashes under every symmetry (see bookKey)
+static uint64_t positionKey(const Board *board, const uint64_t *hashes, int seat, int *symmetry) {
+    int best = 0;
+    for (int s = 1; s < BOARD_SYMMETRIES; s++) {
+        if (hashes[s] < hashes[best]) best = s;
+    }
+    *symmetry = best;
+    return (board->players > 2) ? hashes[best] ^ zobristKey(seat, BOARD_MAX_CELLS) : hashes[best];
+}
+
+// One ply further from the end: a win in n plies is a win in n + 1 from the parent
+static int fartherAway(int score) {
+    return score > 0 ? score - 1 : score < 0 ? score + 1 : 0;
+}
+
+// Exact score for seat: 2 players = negamax for the side to move (seat ==
+// toMove), 3 players = seat alone against the other two. Returns a score
+// outside the SOLVE_WIN range if memory runs out. K-in-a-row moves are made
+// and unmade on board in place; full-line boards copy it per move like
+// negamax does. Either way board is back to the same position on return.
+static int solve(Solver *solver, Board *board, const uint64_t *hashes, int toMove, int seat) {
+    int symmetry, score, move;
+    uint64_t key = positionKey(board, hashes, seat, &symmetry);
+    if (memoFind(&solver->memo, key, &score, &move)) return score;
+
+    int next = (toMove + 1) % board->players;
+    int maximize = (toMove == seat);
+    int copyMake = board->winLength == board->size;
+    int best = maximize ? -SOLVE_WIN : SOLVE_WIN, bestCell = -1;
+
+    for (int cell = 0; cell < board->cells; cell++) {
+        if (bitTest(&board->occupied, cell)) continue;
+
+        int row = cell / board->size, col = cell % board->size;
+        Board child;
+        Board *pos = board;
+        if (copyMake) {
+            child = *board;
+            pos = &child;
+        }
+        if (boardPlace(pos, row, col, toMove)) {
+            score = maximize ? SOLVE_WIN - 1 : -(SOLVE_WIN - 1);
+        } else if (boardIsDraw(pos)) {
+            score = 0;
+        } else {
+            uint64_t childHashes[BOARD_SYMMETRIES];
+            for (int s = 0; s < BOARD_SYMMETRIES; s++) {
+                childHashes[s] = hashes[s] ^ solver->symmetryKey[s][toMove][cell];
+            }
+            score = solve(solver, pos, childHashes, next, board->players == 2 ? next : seat);
+            if (score <= SOLVE_WIN) score = fartherAway(board->players == 2 ? -score : score);
+        }
+        if (!copyMake) boardUnplace(board, row, col, toMove);
+        if (score > SOLVE_WIN) return score;
+        if (bestCell < 0 || (maximize ? score > best : score < best)) {
+            best = score;
+            bestCell = cell;
+        }
+    }
+    if (!memoAdd(&solver->memo, key, best, solver->symmetryCell[symmetry][bestCell])) return SOLVE_WIN + 1;
+    return best;
+}
+
+// Add every position seat can face while playing the solution to table
+// (board is made and unmade in place)
+static int collect(Solver *solver, BookTable *table, Board *board, const uint64_t *hashes, int toMove, int seat) {
+    int symmetry, score, move;
+    uint64_t key = positionKey(board, hashes, seat, &symmetry);
+    uint64_t visitKey = key ^ zobristKey(seat, BOARD_MAX_CELLS + 1);  // Each seat's walk separately
+    if (memoFind(&solver->visited, visitKey, NULL, NULL)) return 1;
+    if (!memoAdd(&solver->visited, visitKey, 0, 0)) return 0;
+
+    int first = 0, last = board->cells - 1;
+    if (toMove == seat) {
+        // The computer plays only the solution's move here
+        if (!memoFind(&solver->memo, key, &score, &move)) return 0;
+        BookOutcome outcome = score > 0 ? BOOK_WIN : score < 0 ? BOOK_LOSS : BOOK_DRAW;
+        int plies = score > 0 ? SOLVE_WIN - score : score < 0 ? SOLVE_WIN + score : 0;
+        if (!bookTableAdd(table, key, bookEntry(key, outcome, plies, move))) return 0;
+        first = last = solver->symmetryCell[boardSymmetryInverse(symmetry)][move];
+    }
+
+    for (int cell = first; cell <= last; cell++) {
+        if (bitTest(&board->occupied, cell)) continue;
+        int row = cell / board->size, col = cell % board->size;
+        int ok = 1;
+        if (!boardPlace(board, row, col, toMove) && !boardIsDraw(board)) {
+            uint64_t childHashes[BOARD_SYMMETRIES];
+            for (int s = 0; s < BOARD_SYMMETRIES; s++) childHashes[s] = hashes[s] ^ solver->symmetryKey[s][toMove][cell];
+            ok = collect(solver, table, board, childHashes, (toMove + 1) % board->players, seat);
+        }
+        boardUnplace(board, row, col, toMove);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+static int solveBoard(BookTable *table, int size, int players, int winLength) {
+    static Solver solver;  // Large symmetry tables - keep them off the stack
+    Board empty;
+    uint64_t hashes[BOARD_SYMMETRIES] = { 0 };
+    double start = nowSeconds();
+
+    boardInitRule(&empty, size, players, winLength);
+    solverTables(&solver, size, players);
+    if (!bookTableInit(table, size, players, winLength, 1) || !memoInit(&solver.memo, 1 << 16) ||
+        !memoInit(&solver.visited, 1 << 16)) {
+        memoFree(&solver.memo);
+        memoFree(&solver.visited);
+        return 0;
+    }
+
+    int ok = 1;
+    int score = 0;
+    // 2 players: one negamax solves both seats; 3 players: one solve per seat
+    for (int seat = 0; seat < players && ok; seat++) {
+        if (seat == 0 || players > 2) score = solve(&solver, &empty, hashes, 0, seat);
+        ok = score <= SOLVE_WIN && collect(&solver, table, &empty, hashes, 0, seat);
+        if (ok && (seat == 0 || players > 2)) {
+            printf("  %dx%d, %d players, %d in a row: %s for %c with perfect play\n", size, size, players, winLength,
+                   score > 0 ? "win" : score < 0 ? "loss" : "draw", playerToSymbol(seat));
+        }
+    }
+    printf("  %zu positions solved, %lld kept in %.2f s\n", solver.memo.count, table->entries, nowSeconds() - start);
+    memoFree(&solver.memo);
+    memoFree(&solver.visited);
+    return ok;
+}
+
+// Search every position of the first plies (once per symmetry class)
+static int bookPositions(AiContext *ai, const AiLimits *limits, BookTable *table, const Board *board, int toMove,
+                         int pliesLeft) {
+    int symmetry;
+    uint64_t key = bookKey(board, toMove, &symmetry);
+    if (bookTableHas(table, key)) return 1;  // A symmetric position was already searched
+
+    AiResult result;
+    aiClear(ai);
+    aiSearch(ai, board, toMove, limits, &result);
+    int move = boardSymmetryCell(board->size, symmetry, result.row * board->size + result.col);
+    if (!bookTableAdd(table, key, bookEntry(key, BOOK_UNKNOWN, 0, move))) return 0;
+    if (pliesLeft <= 1) return 1;
+
+    for (int cell = 0; cell < board->cells; cell++) {
+        if (bitTest(&board->occupied, cell)) continue;
+        Board child = *board;
+        if (boardPlace(&child, cell / board->size, cell % board->size, toMove) || boardIsDraw(&child)) continue;
+        if (!bookPositions(ai, limits, table, &child, (toMove + 1) % board->players, pliesLeft - 1)) return 0;
+    }
+    return 1;
+}
+
+static int openingBook(BookTable *table, int size, int players, int plies, int depth, int threads) {
+    AiContext *ai = aiCreate(AI_DEFAULT_TT_BITS, threads);
+    AiLimits limits = { 0, depth, NULL };
+    Board empty;
+    double start = nowSeconds();
+
+    boardInit(&empty, size, players);
+    int ok = ai != NULL && bookTableInit(table, size, players, size, 0) &&
+             bookPositions(ai, &limits, table, &empty, 0, plies);
+    aiDestroy(ai);
+    if (ok) {
+        printf("  %dx%d, %d players: %lld opening positions in %.2f s\n", size, size, players, table->entries,
+               nowSeconds() - start);
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    const char *out = BOOK_DEFAULT_PATH;
+    const char *solveList = DEFAULT_SOLVE;
+    const char *bookSizes = "5-10";
+    int plies = DEFAULT_BOOK_PLIES, depth = DEFAULT_BOOK_DEPTH, threads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value != NULL && strcmp(argv[i], "--out") == 0) out = value;
+        else if (value != NULL && strcmp(argv[i], "--solve") == 0) solveList = value;
+        else if (value != NULL && strcmp(argv[i], "--book") == 0) bookSizes = value;
+        else if (value != NULL && strcmp(argv[i], "--book-plies") == 0) plies = atoi(value);
+        else if (value != NULL && strcmp(argv[i], "--book-depth") == 0) depth = atoi(value);
+        else if (value != NULL && strcmp(argv[i], "--threads") == 0) threads = atoi(value);
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        i++;  // Every option takes one value
+    }
+
+    BookTable tables[BOOK_MAX_SECTIONS];
+    int count = 0, ok = 1;
+
+    if (strcmp(solveList, "none") != 0) {
+        printf("Solving:\n");
+        for (const char *p = solveList; *p != '\0' && ok; ) {
+            int size = 0, players = 0, winLength = 0, used = 0;
+            if (sscanf(p, "%d:%d%n:%d%n", &size, &players, &used, &winLength, &used) < 2) winLength = -1;
+            if (winLength == 0) winLength = size;
+            if (size < BOARD_MIN_SIZE || size * size > MAX_SOLVE_CELLS || players < 2 || players > BOARD_MAX_PLAYERS ||
+                winLength < BOARD_MIN_SIZE || winLength > size || count == BOOK_MAX_SECTIONS) {
+                printf("Cannot solve '%s' (SIZE:PLAYERS[:WIN], boards up to 4x4).\n", p);
+                return 1;
+            }
+            ok = solveBoard(&tables[count++], size, players, winLength);
+            p += used;
+            if (*p == ',') p++;
+        }
+    }
+
+    int low = 0, high = -1;
+    if (strcmp(bookSizes, "none") != 0 &&
+        (sscanf(bookSizes, "%d-%d", &low, &high) != 2 || low < BOARD_MIN_SIZE || high > BOARD_MAX_SIZE)) {
+        printf("--book needs sizes A-B from %d to %d.\n", BOARD_MIN_SIZE, BOARD_MAX_SIZE);
+        return 1;
+    }
+    if (low <= high && ok) printf("Opening book (%d plies, depth %d):\n", plies, depth);
+    for (int size = low; size <= high && ok; size++) {
+        for (int players = 2; players <= BOARD_MAX_PLAYERS && ok && count < BOOK_MAX_SECTIONS; players++) {
+            ok = openingBook(&tables[count++], size, players, plies, depth, threads);
+        }
+    }
+
+    if (!ok) {
+        printf("Not enough memory.\n");
+    } else if (!bookWrite(out, tables, count)) {
+        printf("Cannot write %s.\n", out);
+        ok = 0;
+    } else {
+        printf("Wrote %s (%d tables).\n", out, count);
+    }
+    for (int i = 0; i < count; i++) bookTableFree(&tables[i]);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <string.h>
+#include "computer.h"
+
+static const char *ENGINE_NAMES[] = { "minimax", "mcts", "random" };
+
+int parseEngine(const char *name, EngineType *engine) {
+    if (strcmp(name, "ai") == 0) {
+        *engine = ENGINE_MINIMAX;
+        return 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, ENGINE_NAMES[i]) == 0) {
+            *engine = (EngineType)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *engineName(EngineType engine) {
+    return ENGINE_NAMES[engine];
+}
+
+void computerDefaults(ComputerSettings *settings) {
+    settings->engine = ENGINE_MINIMAX;
+    settings->threads = aiDefaultThreads();
+    settings->timeLimit = AI_DEFAULT_TIME;
+    settings->maxDepth = 0;
+    settings->playouts = MCTS_DEFAULT_PLAYOUTS;
+    settings->ttBits = AI_DEFAULT_TT_BITS;
+    settings->mctsNodes = MCTS_DEFAULT_NODES;
+    settings->bookPath = BOOK_DEFAULT_PATH;
+}
+
+int computerInit(ComputerPlayer *cp, const ComputerSettings *settings) {
+    memset(cp, 0, sizeof(*cp));
+    rngSeed(&cp->rng, 1);
+    cp->engine = settings->engine;
+    cp->aiLimits.timeLimit = settings->timeLimit;
+    cp->aiLimits.maxDepth = settings->maxDepth;
+    cp->mctsLimits.timeLimit = settings->timeLimit;
+    cp->mctsLimits.playouts = settings->playouts;
+    if (settings->bookPath != NULL && cp->engine != ENGINE_RANDOM) bookOpen(&cp->book, settings->bookPath);
+
+    if (cp->engine == ENGINE_MINIMAX) {
+        cp->ai = aiCreate(settings->ttBits, settings->threads);
+        return cp->ai != NULL;
+    }
+    if (cp->engine == ENGINE_MCTS) {
+        cp->mcts = mctsCreate(settings->mctsNodes);
+        return cp->mcts != NULL;
+    }
+    return 1;
+}
+
+void computerFree(ComputerPlayer *cp) {
+    aiDestroy(cp->ai);
+    mctsDestroy(cp->mcts);
+    bookClose(&cp->book);
+    cp->ai = NULL;
+    cp->mcts = NULL;
+}
+
+void computerSeed(ComputerPlayer *cp, uint64_t seed) {
+    rngSeed(&cp->rng, seed);
+    if (cp->mcts != NULL) mctsSeed(cp->mcts, rngNext(&cp->rng));
+}
+
+void computerNewGame(ComputerPlayer *cp) {
+    if (cp->ai != NULL) aiClear(cp->ai);
+}
+
+// Describe a book answer in cp->report
+static void bookReport(ComputerPlayer *cp, const BookMove *move) {
+    static const char *OUTCOMES[] = { "", "win", "draw", "loss" };
+    if (!move->solved) {
+        snprintf(cp->report, sizeof(cp->report), "Opening book move");
+    } else if (move->outcome == BOOK_DRAW) {
+        snprintf(cp->report, sizeof(cp->report), "Solved position: draw with perfect play");
+    } else {
+        snprintf(cp->report, sizeof(cp->report), "Solved position: %s in %d %s", OUTCOMES[move->outcome],
+                 move->plies, move->plies == 1 ? "move" : "moves");
+    }
+}
+
+void computerMove(ComputerPlayer *cp, const Board *board, int player, int *row, int *col) {
+    BookMove move;
+    cp->replyRow = cp->replyCol = -1;
+    if (cp->book.sectionCount > 0 && bookLookup(&cp->book, board, player, &move)) {
+        *row = move.row;
+        *col = move.col;
+        bookReport(cp, &move);
+    } else if (cp->engine == ENGINE_MINIMAX) {
+        AiResult result;
+        aiSearch(cp->ai, board, player, &cp->aiLimits, &result);
+        *row = result.row;
+        *col = result.col;
+        cp->replyRow = result.replyRow;
+        cp->replyCol = result.replyCol;
+        snprintf(cp->report, sizeof(cp->report), "Searched %d moves ahead (%lld positions, %.0f nodes/sec)",
+                 result.depth, result.nodes, result.nodesPerSec);
+    } else if (cp->engine == ENGINE_MCTS) {
+        MctsResult result;
+        mctsSearch(cp->mcts, board, player, &cp->mctsLimits, &result);
+        *row = result.row;
+        *col = result.col;
+        snprintf(cp->report, sizeof(cp->report), "Played %lld random games (%.0f playouts/sec, %.0f%% expected score)",
+                 result.playouts, result.playoutsPerSec, result.winRate * 100);
+    } else {
+        boardRandomMove(board, &cp->rng, row, col);
+        snprintf(cp->report, sizeof(cp->report), "Picked a random empty cell");
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef COMPUTER_H
+#define COMPUTER_H
+
+#include "board.h"
+#include "ai.h"
+#include "mcts.h"
+#include "book.h"
+
+// The Computer player: one interface in front of the available strategies.
+// Positions found in the book file (book.h) are answered from it without a
+// search. Compile together with board.c, ai.c, mcts.c, book.c, archive.c and
+// record.c and link with -pthread -lm.
+
+typedef enum {
+    ENGINE_MINIMAX,  // Alpha-beta search (ai.c)
+    ENGINE_MCTS,     // Monte Carlo Tree Search (mcts.c)
+    ENGINE_RANDOM    // Any empty cell
+} EngineType;
+
+// How the computer plays - fill with computerDefaults() and adjust
+typedef struct {
+    EngineType engine;
+    int threads;          // Search threads for minimax
+    double timeLimit;     // Seconds per move (0 = no time limit)
+    int maxDepth;         // Minimax depth limit (0 = none)
+    long long playouts;   // MCTS playouts per move (0 = time limit only)
+    int ttBits;           // Minimax transposition table size (2^ttBits entries)
+    int mctsNodes;        // MCTS arena size in nodes
+    const char *bookPath; // Book file used by minimax and MCTS when present (NULL = none)
+} ComputerSettings;
+
+typedef struct {
+    EngineType engine;
+    AiLimits aiLimits;
+    MctsLimits mctsLimits;
+    AiContext *ai;      // Only for ENGINE_MINIMAX
+    MctsContext *mcts;  // Only for ENGINE_MCTS
+    Book book;          // Mapped book file (book.sectionCount 0 = none)
+    Rng rng;            // Random numbers for ENGINE_RANDOM
+    char report[128];   // One-line summary of the last search
+    int replyRow, replyCol;  // Answer the last minimax search expects from the next player (-1 = unknown)
+} ComputerPlayer;
+
+// Parse "minimax" (or "ai"), "mcts" or "random"; returns 0 for an unknown name
+int parseEngine(const char *name, EngineType *engine);
+const char *engineName(EngineType engine);
+
+// Interactive defaults: minimax on every core, AI_DEFAULT_TIME per move,
+// BOOK_DEFAULT_PATH as the book
+void computerDefaults(ComputerSettings *settings);
+
+// Set up a computer player and map its book (a missing book is not an
+// error). Returns 0 if out of memory.
+int computerInit(ComputerPlayer *cp, const ComputerSettings *settings);
+void computerFree(ComputerPlayer *cp);
+
+// Seed every random choice the player makes (random moves, MCTS playouts)
+void computerSeed(ComputerPlayer *cp, uint64_t seed);
+
+// Forget what earlier games taught the engine, so a game's moves depend
+// only on its own position and random numbers
+void computerNewGame(ComputerPlayer *cp);
+
+// Choose a move for player and describe the search in cp->report
+void computerMove(ComputerPlayer *cp, const Board *board, int player, int *row, int *col);
+
+#endif
@@ -0,0 +1,412 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "game.h"
+#include "render.h"
+#include "think.h"
+
+int gameParseNames(const char *list, char names[][GAME_NAME_MAX]) {
+    int count = 0;
+    while (count < BOARD_MAX_PLAYERS) {
+        const char *end = strchr(list, ',');
+        size_t length = end ? (size_t)(end - list) : strlen(list);
+        if (length == 0) return 0;
+        if (length >= GAME_NAME_MAX) length = GAME_NAME_MAX - 1;
+        memcpy(names[count], list, length);
+        names[count][length] = '\0';
+        count++;
+        if (end == NULL) return count;
+        list = end + 1;
+    }
+    return 0;  // More names than seats
+}
+
+int gameSetupFromOptions(GameSetup *setup, const GameOptions *opts) {
+    memset(setup, 0, sizeof(*setup));
+    setup->mode = opts->mode;
+    setup->size = opts->size;
+    setup->winLength = opts->winLength;
+
+    if (setup->mode != 0 && (setup->mode < 1 || setup->mode > 3)) {
+        printf("Wrong mode.\n");
+        return 0;
+    }
+    if (setup->size != 0 && setup->size != GAME_SIZE_UNBOUNDED &&
+        (setup->size < BOARD_MIN_SIZE || setup->size > BIG_MAX_SIZE)) {
+        printf("Wrong size.\n");
+        return 0;
+    }
+    if (setup->winLength != 0 && (setup->winLength < BOARD_MIN_SIZE || setup->winLength > BOARD_MAX_SIZE ||
+                                  (setup->size > 0 && setup->winLength > setup->size))) {
+        printf("Wrong win length.\n");
+        return 0;
+    }
+    if (opts->names != NULL) {
+        int wanted = (setup->mode == 3) ? 3 : (setup->mode == 2) ? 1 : 2;  // The computer needs no name
+        if (setup->mode == 0) {
+            printf("--names needs --mode.\n");
+            return 0;
+        }
+        if (gameParseNames(opts->names, setup->names) != wanted) {
+            printf("--names needs %d %s for mode %d.\n", wanted, wanted == 1 ? "name" : "names", setup->mode);
+            return 0;
+        }
+        setup->namesGiven = 1;
+    }
+    return 1;
+}
+
+int gameAskSetup(GameSetup *setup) {
+    if (setup->mode == 0) {
+        printf("Game Modes:\n");
+        printf("1. Two Players\n");
+        printf("2. Play vs Computer\n");
+        printf("3. Three Players\n");
+        printf("Enter choice (1-3): ");
+        if (scanf("%d", &setup->mode) != 1 || setup->mode < 1 || setup->mode > 3) {
+            printf("Wrong mode.\n");
+            return 0;
+        }
+    }
+    if (setup->size == 0) {
+        printf("Enter board size (%d to %d): ", BOARD_MIN_SIZE, BOARD_MAX_SIZE);
+        if (scanf("%d", &setup->size) != 1 || setup->size < BOARD_MIN_SIZE || setup->size > BOARD_MAX_SIZE) {
+            printf("Wrong size.\n");
+            return 0;
+        }
+    }
+    if (setup->size > 0 && setup->winLength > setup->size) {  // Board chosen at the prompt is too small for --win-length
+        printf("Wrong win length.\n");
+        return 0;
+    }
+    setup->players = (setup->mode == 3) ? 3 : 2;  // 3 players for mode 3, otherwise 2
+
+    if (!setup->namesGiven) {
+        char format[16];
+        snprintf(format, sizeof(format), "%%%ds", GAME_NAME_MAX - 1);  // Never overflow a name
+        for (int i = 0; i < setup->players; i++) {
+            if (setup->mode == 2 && i == 1) break;
+            if (setup->mode == 2) {
+                printf("Enter your name (X): ");
+            } else {
+                if (setup->mode == 3 && i == 0) printf("(Name a player Computer to let the computer play that seat)\n");
+                printf("Enter Player %d name (%c): ", i + 1, playerToSymbol(i));
+            }
+            if (scanf(format, setup->names[i]) != 1) return 0;
+        }
+    }
+    if (setup->mode == 2) strcpy(setup->names[1], "Computer");
+
+    for (int i = 0; i < setup->players; i++) {
+        setup->isComputer[i] = (setup->mode == 2 && i == 1) ||
+                               (setup->mode == 3 && strcmp(setup->names[i], "Computer") == 0);
+    }
+    return 1;
+}
+
+typedef enum {
+    INPUT_END,   // Input ended
+    INPUT_MOVE,  // "row col"
+    INPUT_UNDO,  // "undo": take back the last move
+    INPUT_REDO,  // "redo": play the moves taken back again
+    INPUT_NOW    // "now": the computer should move at once
+} InputKind;
+
+// Read "row col" (1-based) or a command word. A line that is neither is
+// skipped and gives an off-board move.
+static InputKind readInput(int *row, int *col) {
+    char word[16];
+    if (scanf("%15s", word) != 1) return INPUT_END;
+    if (strcmp(word, "undo") == 0) return INPUT_UNDO;
+    if (strcmp(word, "redo") == 0) return INPUT_REDO;
+    if (strcmp(word, "now") == 0) return INPUT_NOW;
+
+    char *end;
+    long value = strtol(word, &end, 10);
+    if (end != word && *end == '\0') {
+        int got = scanf("%d", col);
+        if (got == EOF) return INPUT_END;
+        if (got == 1) {
+            *row = (int)value;
+            return INPUT_MOVE;
+        }
+    }
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) {}
+    if (c == EOF) return INPUT_END;
+    *row = *col = 0;
+    return INPUT_MOVE;
+}
+
+int gameIsLarge(const GameSetup *setup) {
+    return setup->size == GAME_SIZE_UNBOUNDED || setup->size > BOARD_MAX_SIZE;
+}
+
+// The result in the text log layout (text logs only - large boards do not
+// fit binary records)
+static void logLargeResult(GameLog *log, const GameSetup *setup, int winLength, int winner) {
+    if (setup->size == GAME_SIZE_UNBOUNDED) gameLogPrintf(log, "Game Mode: %d\nBoard Size: unbounded\n", setup->mode);
+    else gameLogPrintf(log, "Game Mode: %d\nBoard Size: %d x %d\n", setup->mode, setup->size, setup->size);
+    gameLogPrintf(log, "Win Length: %d\nPlayers: ", winLength);
+    for (int i = 0; i < setup->players; i++) {
+        gameLogPrintf(log, "%s (%c)%s", setup->names[i], playerToSymbol(i), (i < setup->players - 1) ? ", " : "\n");
+    }
+    if (winner >= 0) gameLogPrintf(log, "Winner: %s\n", setup->names[winner]);
+    else gameLogPrintf(log, "Result: Draw\n");
+    gameLogPrintf(log, "-----------------------------\n");
+    gameLogFlush(log);
+}
+
+// gamePlay on a large board: only the occupied tiles are stored
+static int playLarge(const GameSetup *setup, GameLog *log) {
+    int unbounded = (setup->size == GAME_SIZE_UNBOUNDED);
+    int shown = unbounded ? 0 : 1;  // Added to coordinates shown and typed
+    int winLength = setup->winLength > 0 ? setup->winLength : BIG_DEFAULT_WIN;
+
+    BigBoard board;
+    if (!bigInit(&board, unbounded ? BIG_UNBOUNDED : setup->size, setup->players, winLength)) {
+        printf("Not enough memory for the board.\n");
+        return GAME_ABANDONED;
+    }
+    printf("%d in a row wins.\n", winLength);
+    renderViewport(&board, RENDER_VIEWPORT, RENDER_VIEWPORT);
+
+    int result = GAME_ABANDONED;
+    for (int turn = 0; ; ) {
+        int player = turn % setup->players;
+        const char *name = setup->names[player];
+        char symbol = playerToSymbol(player);
+        int row, col;
+
+        if (setup->isComputer[player]) {
+            printf("%s's turn (%c)...\n", name, symbol);
+            bigComputerMove(&board, player, &row, &col);
+            printf("Computer chose: %d %d\n", row + shown, col + shown);
+        } else {
+            if (unbounded) printf("%s's turn (%c). Enter row and column: ", name, symbol);
+            else printf("%s's turn (%c). Enter row and column (1 to %d): ", name, symbol, setup->size);
+            InputKind input = readInput(&row, &col);
+            if (input == INPUT_END) {
+                printf("\nInput ended - game abandoned.\n");
+                gameLogAbandon(log);
+                break;
+            }
+            if (input != INPUT_MOVE) {
+                printf("Only moves can be entered on a large board.\n");
+                continue;
+            }
+            row -= shown;
+            col -= shown;
+        }
+
+        if (!bigIsValidMove(&board, row, col)) {
+            printf("Bad move! Try again.\n");
+            continue;
+        }
+        int won = bigPlace(&board, row, col, player);
+        if (won < 0) {
+            printf("Not enough memory for the board - game abandoned.\n");
+            gameLogAbandon(log);
+            break;
+        }
+        gameLogPrintf(log, "Move %d: %s (%c) -> Row %d, Col %d\n", turn + 1, name, symbol, row + shown, col + shown);
+        renderViewport(&board, RENDER_VIEWPORT, RENDER_VIEWPORT);
+
+        if (won) {
+            printf("%s wins!\n", name);
+            logLargeResult(log, setup, winLength, player);
+            result = player;
+            break;
+        }
+        if (bigIsDraw(&board)) {
+            printf("Game draw!\n");
+            logLargeResult(log, setup, winLength, -1);
+            result = -1;
+            break;
+        }
+        turn++;
+    }
+
+    bigFree(&board);
+    return result;
+}
+
+// Take back the last move, then any computer moves before it, so that a
+// human is to move again (in an all-computer game: back to the start). Each
+// move is unmade in place. Returns 0 if there is nothing to take back.
+static int takeBack(GameState *state, const GameSetup *setup, GameLog *log) {
+    const Board *board = &state->board;
+    if (board->moveCount == 0) return 0;
+    do {
+        int count = board->moveCount - 1;
+        int player = count % setup->players;
+        int cell = state->moves[count];
+        gameLogUndo(log, count + 1, setup->names[player], player, cell / board->size, cell % board->size);
+        printf("Took back %c at %d %d\n", playerToSymbol(player), cell / board->size + 1, cell % board->size + 1);
+        gameStateUnmake(state);
+    } while (board->moveCount > 0 && setup->isComputer[gameStateToMove(state)]);
+    return 1;
+}
+
+// Play the moves taken back again: the next one, then any computer moves
+// after it, stopping where a human is to move or the game ends. Returns 0 if
+// there is nothing to redo.
+static int replay(GameState *state, const GameSetup *setup, GameLog *log) {
+    const Board *board = &state->board;
+    if (board->moveCount == state->moveTotal) return 0;
+    do {
+        int count = board->moveCount;
+        int player = count % setup->players;
+        int cell = state->moves[count];
+        gameStateRedo(state);
+        gameLogMove(log, count + 1, setup->names[player], player, cell / board->size, cell % board->size);
+        printf("Replayed %c at %d %d\n", playerToSymbol(player), cell / board->size + 1, cell % board->size + 1);
+    } while (board->moveCount < state->moveTotal && board->winner < 0 && !boardIsDraw(board) &&
+             setup->isComputer[gameStateToMove(state)]);
+    return 1;
+}
+
+// The computer's move for player. With a thinker the search runs in the
+// background while a player at the terminal may type "now" (move at once)
+// or "undo". Returns INPUT_MOVE with the move in row, col, or INPUT_UNDO or
+// INPUT_END with the search dropped.
+static InputKind computerTurn(ComputerPlayer *computer, Thinker *thinker, const Board *board, int player,
+                              int *row, int *col) {
+    if (thinker == NULL) {
+        computerMove(computer, board, player, row, col);
+        return INPUT_MOVE;
+    }
+    if (!thinkPonderHit(thinker, board, player)) thinkStart(thinker, board, player);
+    while (thinkWait(thinker, 1) == THINK_INPUT) {
+        int typedRow, typedCol;
+        InputKind input = readInput(&typedRow, &typedCol);
+        if (input == INPUT_NOW) {
+            thinkStop(thinker);
+        } else if (input == INPUT_UNDO || input == INPUT_END) {
+            thinkCancel(thinker);
+            return input;
+        } else {
+            printf("The computer is thinking - type now or undo.\n");
+        }
+    }
+    thinkResult(thinker, row, col);
+    return INPUT_MOVE;
+}
+
+// After a computer move: when a human moves next and the computer right
+// after, search the position after the reply the computer expects while
+// the human thinks
+static void ponderReply(Thinker *thinker, const ComputerPlayer *computer, const GameSetup *setup,
+                        const Board *board) {
+    int human = board->moveCount % setup->players;
+    int next = (human + 1) % setup->players;
+    if (computer->replyRow < 0 || setup->isComputer[human] || !setup->isComputer[next]) return;
+
+    Board expected = *board;
+    if (!boardIsValidMove(&expected, computer->replyRow, computer->replyCol)) return;
+    if (boardPlace(&expected, computer->replyRow, computer->replyCol, human) || boardIsDraw(&expected)) return;
+    thinkPonder(thinker, &expected, next);
+}
+
+int gamePlay(const GameSetup *setup, const ComputerSettings *settings, GameLog *log,
+             GameDisplay display, void *context) {
+    if (gameIsLarge(setup)) return playLarge(setup, log);
+
+    int anyComputer = 0, anyHuman = 0;
+    for (int i = 0; i < setup->players; i++) {
+        anyComputer |= setup->isComputer[i];
+        anyHuman |= !setup->isComputer[i];
+    }
+
+    ComputerPlayer computer = { 0 };
+    if (anyComputer && !computerInit(&computer, settings)) {
+        printf("Not enough memory for the computer player.\n");
+        return GAME_ABANDONED;
+    }
+    computerSeed(&computer, (uint64_t)time(NULL));  // Different computer moves every game
+    // Searches run in the background; without a thread they run here
+    Thinker *thinker = anyComputer ? thinkCreate(&computer) : NULL;
+    if (thinker != NULL && anyHuman && thinkInputIsInteractive()) {
+        printf("While the computer thinks, type now to make it move at once or undo to take back your move.\n");
+    }
+
+    // One contiguous bitboard and its move stack (undo / redo), no allocation
+    int winLength = setup->winLength > 0 ? setup->winLength : setup->size;
+    GameState state;
+    const Board *board = &state.board;
+    gameStateInit(&state, setup->size, setup->players, winLength);
+    if (winLength < setup->size) printf("%d in a row wins.\n", winLength);
+    display(context, board);
+
+    const char *names[BOARD_MAX_PLAYERS] = { setup->names[0], setup->names[1], setup->names[2] };
+    int result = GAME_ABANDONED;
+    for (;;) {
+        int turn = board->moveCount;
+        int player = gameStateToMove(&state);  // Cycle through players
+        const char *name = setup->names[player];
+        char symbol = playerToSymbol(player);
+        int row, col;
+        InputKind input;
+
+        if (setup->isComputer[player]) {
+            printf("%s's turn (%c)...\n", name, symbol);
+            input = computerTurn(&computer, thinker, board, player, &row, &col);
+            if (input == INPUT_MOVE) {
+                printf("Computer chose: %d %d\n", row + 1, col + 1);
+                printf("%s\n", computer.report);
+            }
+        } else {
+            printf("%s's turn (%c). Enter row and column (1 to %d): ", name, symbol, setup->size);
+            input = readInput(&row, &col);
+            row -= 1;  // Convert from 1-based to 0-based indexing
+            col -= 1;
+        }
+
+        if (input == INPUT_END) {
+            printf("\nInput ended - game abandoned.\n");
+            gameLogAbandon(log);
+            break;
+        }
+        if (input == INPUT_UNDO) {
+            if (thinker != NULL) thinkCancel(thinker);  // Drop any pondering
+            if (takeBack(&state, setup, log)) display(context, board);
+            else printf("Nothing to take back.\n");
+            continue;
+        }
+        if (input == INPUT_REDO) {
+            if (!replay(&state, setup, log)) {
+                printf("Nothing to redo.\n");
+                continue;
+            }
+        } else if (input != INPUT_MOVE || !boardIsValidMove(board, row, col)) {
+            printf("Bad move! Try again.\n");
+            continue;  // Same player again
+        } else {
+            gameStateMake(&state, row, col);
+            gameLogMove(log, turn + 1, name, player, row, col);
+        }
+        display(context, board);
+
+        if (board->winner >= 0) {
+            printf("%s wins!\n", setup->names[board->winner]);
+            gameLogResult(log, setup->mode, setup->size, winLength, setup->players, names, board->winner);
+            result = board->winner;
+            break;
+        }
+        if (boardIsDraw(board)) {  // Board full or every line blocked
+            printf("Game draw!\n");
+            gameLogResult(log, setup->mode, setup->size, winLength, setup->players, names, -1);
+            result = -1;
+            break;
+        }
+        // Ponder only after a fresh search: its expected reply fits this position
+        if (thinker != NULL && setup->isComputer[player] && input == INPUT_MOVE) {
+            ponderReply(thinker, &computer, setup, board);
+        }
+    }
+
+    thinkDestroy(thinker);
+    computerFree(&computer);  // Free the computer player's search tables
+    return result;
+}
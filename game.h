@@ -0,0 +1,63 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "board.h"
+#include "computer.h"
+#include "gamelog.h"
+#include "options.h"
+#include "bigboard.h"
+
+// The interactive game shared by every front end: who plays (GameSetup,
+// from the command line and/or prompts) and the turn loop itself. The
+// front end only decides how the board is shown. Part of the game core.
+
+#define GAME_NAME_MAX 50    // Longest player name, with its terminator
+#define GAME_ABANDONED -2   // gamePlay result when input ends mid-game
+
+typedef struct {
+    int mode;       // 1 = two players, 2 = vs computer, 3 = three players (0 = not chosen yet)
+    int size;       // Board size (0 = not chosen yet, GAME_SIZE_UNBOUNDED = no edges)
+    int winLength;  // Marks in a row that win (0 = the full line, or BIG_DEFAULT_WIN on a large board)
+    int players;    // 2, or 3 for mode 3
+    int namesGiven; // 1 = names came from --names
+    char names[BOARD_MAX_PLAYERS][GAME_NAME_MAX];
+    int isComputer[BOARD_MAX_PLAYERS];  // Seat played by the computer
+} GameSetup;
+
+// Copy a comma-separated name list ("Alice,Bob") into names, each cut to
+// GAME_NAME_MAX - 1 characters. Returns the number of names, or 0 for an
+// empty name or more names than seats.
+int gameParseNames(const char *list, char names[][GAME_NAME_MAX]);
+
+// Take --mode, --size, --names and --win-length from the options; anything not given is
+// left for gameAskSetup. Prints the problem and returns 0 if a value is invalid.
+int gameSetupFromOptions(GameSetup *setup, const GameOptions *opts);
+
+// Prompt for whatever the setup still lacks (mode, size, names) and decide
+// which seats the computer plays: seat 2 in mode 2, and in mode 3 every seat
+// named "Computer". Prints the problem and returns 0 on invalid input.
+int gameAskSetup(GameSetup *setup);
+
+// Called with the board before the first move and after every move
+typedef void (*GameDisplay)(void *context, const Board *board);
+
+// 1 if the setup is played on a large (sparse) board: above BOARD_MAX_SIZE or unbounded
+int gameIsLarge(const GameSetup *setup);
+
+// Play one game: human moves are read from stdin, computer moves come from
+// settings, every move and the result go to log (may be NULL). Returns the
+// winning seat, -1 for a draw, or GAME_ABANDONED if stdin ends first.
+// "undo" instead of a move takes back the last move and the computer moves
+// before it; "redo" plays them again (until a different move is made). The
+// board is a GameState, so both just unmake and remake moves. The computer searches in the background (think.h) and ponders
+// on the human's turn; at a terminal "now" or "undo" can be typed while it
+// thinks.
+// Returns GAME_ABANDONED without playing if the computer cannot be set up.
+// Large boards are played on a BigBoard instead: shown with renderViewport
+// (display is not called), computer seats play bigComputerMove, moves are
+// typed 1-based on a bounded board and as plain coordinates on an unbounded
+// one, and only text logs record the game.
+int gamePlay(const GameSetup *setup, const ComputerSettings *settings, GameLog *log,
+             GameDisplay display, void *context);
+
+#endif
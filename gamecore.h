@@ -0,0 +1,41 @@
+#ifndef GAMECORE_H
+#define GAMECORE_H
+
+// The game core: everything the front ends share, behind one header.
+//
+//   board.h     Board state, moves, win and draw queries (bitboard)
+//   bigboard.h  Sparse tiled board for sizes beyond 10 x 10 and unbounded play
+//   computer.h  Computer players (minimax in ai.h, MCTS in mcts.h, random)
+//   book.h      Solved small boards and opening moves, written by bookgen
+//   think.h     Background searches and pondering for the interactive game
+//   game.h      The interactive game loop and its setup prompts
+//   simulate.h  Headless self-play between computer agents
+//   session.h   Many concurrent games driven by text commands (server.c)
+//   options.h   Command-line options shared by the game programs
+//   gamelog.h   Buffered game log (text, CSV or binary records from record.h)
+//   archive.h   Indexed, memory-mapped reader for saved games
+//   render.h    Terminal board display
+//
+// The Makefile builds these modules into libgamecore.a and libgamecore.so
+// and links every front end and tool against the library.
+//
+// The functions in these headers are the stable interface: front ends use
+// only them (and the documented struct fields), never the engine internals.
+
+#include "board.h"
+#include "bigboard.h"
+#include "computer.h"
+#include "book.h"
+#include "think.h"
+#include "game.h"
+#include "simulate.h"
+#include "session.h"
+#include "options.h"
+#include "gamelog.h"
+#include "record.h"
+#include "archive.h"
+#include "render.h"
+
+#define GAMECORE_VERSION 1  // Raised when a change breaks programs built against the old API
+
+#endif
@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include "gamelog.h"
+
+#define MIN_BUFFER 4096  // Big enough for any single move, result or grid
+
+struct GameLog {
+    FILE *file;
+    GameLogSettings settings;
+    pthread_mutex_t lock;  // Guards everything below
+
+    char *buffer;          // Records are formatted here
+    size_t used;
+
+    // Background writer: the full buffer is swapped with the spare one and
+    // written by the thread while new records go into the other buffer
+    pthread_t thread;
+    pthread_cond_t wake;   // Signals the thread: pending is set, or stopping
+    pthread_cond_t idle;   // Signals writers: pending has been written
+    char *spare;           // Empty buffer to swap in (NULL while the thread holds it)
+    char *pending;         // Buffer the thread is writing, NULL when idle
+    size_t pendingSize;
+    int stopping;
+
+    // Binary format: moves of the game in progress, written with its result
+    int gameMoves;
+    unsigned char gameCells[BOARD_MAX_CELLS];  // row * BOARD_MAX_SIZE + col
+
+    GameLog *next;         // Open logs, flushed at exit
+};
+
+static pthread_mutex_t openLock = PTHREAD_MUTEX_INITIALIZER;
+static GameLog *openLogs = NULL;
+static int exitHookSet = 0;
+
+void gameLogDefaults(GameLogSettings *settings) {
+    settings->format = LOG_FORMAT_TEXT;
+    settings->flush = LOG_FLUSH_GAME;
+    settings->bufferSize = GAMELOG_DEFAULT_BUFFER;
+    settings->background = 0;
+}
+
+int parseLogFormat(const char *name, LogFormat *format) {
+    if (strcmp(name, "text") == 0) *format = LOG_FORMAT_TEXT;
+    else if (strcmp(name, "csv") == 0) *format = LOG_FORMAT_CSV;
+    else if (strcmp(name, "binary") == 0) *format = LOG_FORMAT_BINARY;
+    else return 0;
+    return 1;
+}
+
+int parseLogFlush(const char *name, LogFlush *flush) {
+    if (strcmp(name, "move") == 0) *flush = LOG_FLUSH_MOVE;
+    else if (strcmp(name, "game") == 0) *flush = LOG_FLUSH_GAME;
+    else if (strcmp(name, "full") == 0) *flush = LOG_FLUSH_FULL;
+    else return 0;
+    return 1;
+}
+
+static void *writerThread(void *arg) {
+    GameLog *log = (GameLog *)arg;
+
+    pthread_mutex_lock(&log->lock);
+    while (1) {
+        while (log->pending == NULL && !log->stopping) {
+            pthread_cond_wait(&log->wake, &log->lock);
+        }
+        if (log->pending == NULL) break;  // Stopping and nothing left to write
+
+        char *data = log->pending;
+        size_t size = log->pendingSize;
+        pthread_mutex_unlock(&log->lock);
+        fwrite(data, 1, size, log->file);
+        pthread_mutex_lock(&log->lock);
+
+        log->spare = data;
+        log->pending = NULL;
+        pthread_cond_broadcast(&log->idle);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+// Wait until the writer thread has nothing in hand (lock held)
+static void waitIdle(GameLog *log) {
+    while (log->pending != NULL) {
+        pthread_cond_wait(&log->idle, &log->lock);
+    }
+}
+
+// Pass the buffered records on to the file (lock held)
+static void handOff(GameLog *log) {
+    if (log->used == 0) return;
+
+    if (!log->settings.background) {
+        fwrite(log->buffer, 1, log->used, log->file);
+        log->used = 0;
+        return;
+    }
+    waitIdle(log);  // The thread still has the previous batch
+    log->pending = log->buffer;
+    log->pendingSize = log->used;
+    log->buffer = log->spare;
+    log->spare = NULL;
+    log->used = 0;
+    pthread_cond_signal(&log->wake);
+}
+
+// A move or a game just ended: flush if the policy asks for it (lock held)
+static void endRecord(GameLog *log, LogFlush boundary) {
+    if (log->settings.flush <= boundary) handOff(log);
+}
+
+// printf into the buffer (lock held)
+static void appendV(GameLog *log, const char *format, va_list args) {
+    va_list again;
+    va_copy(again, args);
+
+    size_t space = log->settings.bufferSize - log->used;
+    int length = vsnprintf(log->buffer + log->used, space, format, args);
+    if (length >= 0 && (size_t)length >= space) {
+        // Did not fit: make room and format it again
+        handOff(log);
+        if ((size_t)length < log->settings.bufferSize) {
+            vsnprintf(log->buffer, log->settings.bufferSize, format, again);
+        } else {
+            // Larger than a whole buffer - write it on its own, after what came before
+            char *big = (char *)malloc((size_t)length + 1);
+            if (big != NULL) {
+                vsnprintf(big, (size_t)length + 1, format, again);
+                waitIdle(log);
+                fwrite(big, 1, (size_t)length, log->file);
+                free(big);
+            }
+            length = 0;
+        }
+    }
+    if (length > 0) log->used += (size_t)length;
+    va_end(again);
+}
+
+// Copy raw bytes into the buffer (lock held, length at most MIN_BUFFER)
+static void appendBytes(GameLog *log, const void *data, size_t length) {
+    if (log->used + length > log->settings.bufferSize) handOff(log);
+    memcpy(log->buffer + log->used, data, length);
+    log->used += length;
+}
+
+static void append(GameLog *log, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    appendV(log, format, args);
+    va_end(args);
+}
+
+static void exitHook(void) {
+    while (1) {
+        pthread_mutex_lock(&openLock);
+        GameLog *log = openLogs;
+        pthread_mutex_unlock(&openLock);
+        if (log == NULL) break;
+        gameLogClose(log);
+    }
+}
+
+// An older record file being appended to gets the current header: its
+// records stay valid (version 1 wrote 0 where the win length now goes), and
+// readers that only know the old version then refuse the new records
+// instead of misreading them. Returns 0 if the header cannot be rewritten.
+static int upgradeHeader(const char *path, const unsigned char *found, const unsigned char *header) {
+    if (memcmp(found, header, RECORD_FILE_HEADER) == 0) return 1;
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL) return 0;
+    int ok = fwrite(header, 1, RECORD_FILE_HEADER, file) == RECORD_FILE_HEADER;
+    return (fclose(file) == 0) && ok;
+}
+
+GameLog *gameLogOpen(const char *path, int append, const GameLogSettings *settings) {
+    GameLog *log = (GameLog *)calloc(1, sizeof(GameLog));
+    if (log == NULL) return NULL;
+    log->settings = *settings;
+    if (log->settings.bufferSize < MIN_BUFFER) log->settings.bufferSize = MIN_BUFFER;
+
+    int binary = (log->settings.format == LOG_FORMAT_BINARY);
+    log->file = fopen(path, append ? (binary ? "a+b" : "a") : (binary ? "w+b" : "w"));
+    log->buffer = (char *)malloc(log->settings.bufferSize);
+    if (log->settings.background) log->spare = (char *)malloc(log->settings.bufferSize);
+    if (log->file == NULL || log->buffer == NULL || (log->settings.background && log->spare == NULL)) {
+        if (log->file != NULL) fclose(log->file);
+        free(log->buffer);
+        free(log->spare);
+        free(log);
+        return NULL;
+    }
+    setvbuf(log->file, NULL, _IONBF, 0);  // Batches go straight to the OS
+
+    // A new binary file starts with the format header; records are only
+    // appended to a file that already has one, from this version or older
+    if (binary) {
+        unsigned char header[RECORD_FILE_HEADER], found[RECORD_FILE_HEADER];
+        recordFileHeader(header);
+        fseek(log->file, 0, SEEK_END);
+        if (ftell(log->file) == 0) {
+            fwrite(header, 1, sizeof(header), log->file);
+        } else if (fseek(log->file, 0, SEEK_SET) != 0 ||
+                   fread(found, 1, sizeof(found), log->file) != sizeof(found) || recordFileVersion(found) == 0 ||
+                   recordFileVersion(found) > RECORD_VERSION || !upgradeHeader(path, found, header)) {
+            fclose(log->file);
+            free(log->buffer);
+            free(log->spare);
+            free(log);
+            return NULL;
+        }
+    }
+
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->wake, NULL);
+    pthread_cond_init(&log->idle, NULL);
+    if (log->settings.background && pthread_create(&log->thread, NULL, writerThread, log) != 0) {
+        log->settings.background = 0;  // Fall back to writing on the caller's thread
+        free(log->spare);
+        log->spare = NULL;
+    }
+
+    pthread_mutex_lock(&openLock);
+    log->next = openLogs;
+    openLogs = log;
+    if (!exitHookSet) exitHookSet = (atexit(exitHook) == 0);
+    pthread_mutex_unlock(&openLock);
+    return log;
+}
+
+void gameLogClose(GameLog *log) {
+    if (log == NULL) return;
+
+    pthread_mutex_lock(&openLock);
+    for (GameLog **link = &openLogs; *link != NULL; link = &(*link)->next) {
+        if (*link == log) {
+            *link = log->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&openLock);
+
+    pthread_mutex_lock(&log->lock);
+    handOff(log);
+    log->stopping = 1;
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    if (log->settings.background) pthread_join(log->thread, NULL);
+
+    fclose(log->file);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->wake);
+    pthread_cond_destroy(&log->idle);
+    free(log->buffer);
+    free(log->spare);
+    free(log);
+}
+
+void gameLogFlush(GameLog *log) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    handOff(log);
+    waitIdle(log);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void gameLogPrintf(GameLog *log, const char *format, ...) {
+    if (log == NULL || log->settings.format != LOG_FORMAT_TEXT) return;
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&log->lock);
+    appendV(log, format, args);
+    pthread_mutex_unlock(&log->lock);
+    va_end(args);
+}
+
+void gameLogGrid(GameLog *log, const Board *board) {
+    if (log == NULL || log->settings.format != LOG_FORMAT_TEXT) return;
+    char rows[BOARD_MAX_SIZE * (2 * BOARD_MAX_SIZE + 1) + 1];
+    int length = 0;
+
+    // Build all rows in one go, then copy them as a single record
+    for (int i = 0; i < board->size; i++) {
+        for (int j = 0; j < board->size; j++) {
+            rows[length++] = boardCell(board, i, j);
+            rows[length++] = ' ';
+        }
+        rows[length++] = '\n';
+    }
+    rows[length] = '\0';
+
+    pthread_mutex_lock(&log->lock);
+    append(log, "%s", rows);
+    pthread_mutex_unlock(&log->lock);
+}
+
+// One move line in the selected format (lock held)
+static void appendMove(GameLog *log, int moveNumber, const char *name, int player, int row, int col) {
+    if (log->settings.format == LOG_FORMAT_BINARY) {
+        // Kept until the result arrives - the record header holds the move count
+        if (log->gameMoves < BOARD_MAX_CELLS) {
+            log->gameCells[log->gameMoves++] = (unsigned char)(row * BOARD_MAX_SIZE + col);
+        }
+    } else if (log->settings.format == LOG_FORMAT_CSV) {
+        append(log, "move,%d,%s,%c,%d,%d\n", moveNumber, name, playerToSymbol(player), row + 1, col + 1);
+    } else {
+        append(log, "Move %d: %s (%c) -> Row %d, Col %d\n", moveNumber, name, playerToSymbol(player), row + 1, col + 1);
+    }
+}
+
+// Game result in the selected format (lock held)
+static void appendResult(GameLog *log, int mode, int size, int winLength, int players, const char *const names[],
+                         int winner) {
+    if (log->settings.format == LOG_FORMAT_BINARY) {
+        GameRecord record;
+        unsigned char data[RECORD_MAX_BYTES];
+        memset(&record, 0, sizeof(record));
+        record.size = size;
+        record.winLength = winLength;
+        record.mode = mode;
+        record.players = players;
+        record.winner = winner;
+        record.moveCount = log->gameMoves;
+        for (int i = 0; i < log->gameMoves; i++) {
+            int row = log->gameCells[i] / BOARD_MAX_SIZE, col = log->gameCells[i] % BOARD_MAX_SIZE;
+            record.moves[i] = (unsigned char)(row * size + col);
+        }
+        log->gameMoves = 0;
+        appendBytes(log, data, recordEncode(&record, data));
+        return;
+    }
+    if (log->settings.format == LOG_FORMAT_CSV) {
+        append(log, "result,%d,%d,%s,%c\n", mode, size,
+               winner >= 0 ? names[winner] : "", winner >= 0 ? playerToSymbol(winner) : '-');
+        return;
+    }
+    append(log, "Game Mode: %d\n", mode);
+    append(log, "Board Size: %d x %d\n", size, size);
+    if (winLength < size) append(log, "Win Length: %d\n", winLength);
+    append(log, "Players: ");
+    for (int i = 0; i < players; i++) {
+        append(log, "%s (%c)%s", names[i], playerToSymbol(i), (i < players - 1) ? ", " : "\n");
+    }
+    if (winner >= 0) append(log, "Winner: %s\n", names[winner]);
+    else append(log, "Result: Draw\n");
+    append(log, "-----------------------------\n");
+}
+
+void gameLogMove(GameLog *log, int moveNumber, const char *name, int player, int row, int col) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    appendMove(log, moveNumber, name, player, row, col);
+    endRecord(log, LOG_FLUSH_MOVE);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void gameLogUndo(GameLog *log, int moveNumber, const char *name, int player, int row, int col) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    if (log->settings.format == LOG_FORMAT_BINARY) {
+        if (log->gameMoves > 0) log->gameMoves--;
+    } else if (log->settings.format == LOG_FORMAT_CSV) {
+        append(log, "undo,%d,%s,%c,%d,%d\n", moveNumber, name, playerToSymbol(player), row + 1, col + 1);
+    } else {
+        append(log, "Undo %d: %s (%c) -> Row %d, Col %d\n", moveNumber, name, playerToSymbol(player), row + 1, col + 1);
+    }
+    endRecord(log, LOG_FLUSH_MOVE);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void gameLogAbandon(GameLog *log) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    if (log->settings.format == LOG_FORMAT_BINARY) {
+        log->gameMoves = 0;
+    } else if (log->settings.format == LOG_FORMAT_CSV) {
+        append(log, "abandon\n");
+    } else {
+        append(log, "Game abandoned\n");
+    }
+    endRecord(log, LOG_FLUSH_GAME);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void gameLogResult(GameLog *log, int mode, int size, int winLength, int players, const char *const names[],
+                   int winner) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    appendResult(log, mode, size, winLength, players, names, winner);
+    endRecord(log, LOG_FLUSH_GAME);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void gameLogGame(GameLog *log, const GameRecord *record) {
+    if (log == NULL) return;
+    pthread_mutex_lock(&log->lock);
+    if (log->settings.format == LOG_FORMAT_BINARY) {
+        unsigned char data[RECORD_MAX_BYTES];
+        appendBytes(log, data, recordEncode(record, data));
+        endRecord(log, LOG_FLUSH_GAME);
+        pthread_mutex_unlock(&log->lock);
+        return;
+    }
+    for (int i = 0; i < record->moveCount; i++) {
+        int player = i % record->players;
+        int cell = record->moves[i];
+        appendMove(log, i + 1, record->names[player], player, cell / record->size, cell % record->size);
+    }
+    appendResult(log, record->mode, record->size, record->winLength, record->players, record->names, record->winner);
+    endRecord(log, LOG_FLUSH_GAME);
+    pthread_mutex_unlock(&log->lock);
+}
@@ -0,0 +1,83 @@
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include "board.h"
+#include "record.h"
+
+// Buffered game-log writer. Records are formatted straight into a large
+// in-memory buffer and written to the file in big batches, optionally by a
+// background writer thread, instead of one fprintf per line.
+// Compile together with board.c and record.c, link with -pthread.
+//
+// Every function ignores a NULL log, so a program can keep going without a
+// log file. One log may be shared by several threads - each call is atomic.
+// Logs still open when the program exits are flushed and closed then.
+
+#define GAMELOG_DEFAULT_BUFFER (1 << 20)  // 1 MB per buffer
+
+typedef enum {
+    LOG_FORMAT_TEXT,  // "Move 1: Alice (X) -> Row 2, Col 2" and a result block per game
+    LOG_FORMAT_CSV,   // One comma-separated line per move and per result
+    LOG_FORMAT_BINARY // Compact move-only records (record.h) - about 20 bytes per game
+} LogFormat;
+
+// When buffered records are handed to the file
+typedef enum {
+    LOG_FLUSH_MOVE,  // After every move (nothing lost if the program is killed)
+    LOG_FLUSH_GAME,  // After every finished game
+    LOG_FLUSH_FULL   // Only when the buffer fills up and on close
+} LogFlush;
+
+typedef struct {
+    LogFormat format;
+    LogFlush flush;
+    size_t bufferSize;  // Bytes collected before a batch is written
+    int background;     // 1 = a writer thread does the file I/O
+} GameLogSettings;
+
+typedef struct GameLog GameLog;
+
+// Text format, flush after every game, 1 MB buffer, no writer thread
+void gameLogDefaults(GameLogSettings *settings);
+
+// Parse "text"/"csv"/"binary" and "move"/"game"/"full"; return 0 for an unknown name
+int parseLogFormat(const char *name, LogFormat *format);
+int parseLogFlush(const char *name, LogFlush *flush);
+
+// Open path for appending (append = 1) or from scratch; NULL on failure
+GameLog *gameLogOpen(const char *path, int append, const GameLogSettings *settings);
+
+// Write everything still buffered, stop the writer thread and close the file
+void gameLogClose(GameLog *log);
+
+// Hand everything buffered so far to the file (waits until it is written)
+void gameLogFlush(GameLog *log);
+
+// Free-form text, formatted like printf (text format only - ignored otherwise)
+void gameLogPrintf(GameLog *log, const char *format, ...);
+
+// The board as rows of "X O   " - one line per row (text format only)
+void gameLogGrid(GameLog *log, const Board *board);
+
+// One move (row and col 0-based, written 1-based). Counts as the end of a
+// move for LOG_FLUSH_MOVE.
+void gameLogMove(GameLog *log, int moveNumber, const char *name, int player, int row, int col);
+
+// Take back move moveNumber (the last one logged): text and CSV logs note
+// it, binary records drop it. Counts as the end of a move.
+void gameLogUndo(GameLog *log, int moveNumber, const char *name, int player, int row, int col);
+
+// The game in progress ends without a result: text logs write "Game
+// abandoned" (readers drop the moves before it), CSV logs "abandon", binary
+// records drop its moves. Counts as the end of a game.
+void gameLogAbandon(GameLog *log);
+
+// Result of a game (winner -1 for a draw; winLength = size for the full-line
+// rule). Counts as the end of a game.
+void gameLogResult(GameLog *log, int mode, int size, int winLength, int players, const char *const names[],
+                   int winner);
+
+// A whole game: every move, then the result
+void gameLogGame(GameLog *log, const GameRecord *record);
+
+#endif
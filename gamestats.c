@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aggregate.h"
+#include "ai.h"
+#include "timer.h"
+
+// Offline report over saved game results (multigrids.txt, singlegrid.txt or
+// binary record files): win rates per symbol, board size, mode and player,
+// game length and first-move advantage, as a table or as JSON.
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [--threads N] [--json] FILE...\n", program);
+    printf("  --threads N   Worker threads per text file (default: one per core)\n");
+    printf("  --json        Print JSON instead of the summary table\n");
+}
+
+int main(int argc, char *argv[]) {
+    int threads = aiDefaultThreads();
+    int json = 0;
+    int firstFile = 1;
+
+    for (; firstFile < argc && strncmp(argv[firstFile], "--", 2) == 0; firstFile++) {
+        if (strcmp(argv[firstFile], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[firstFile], "--threads") == 0 && firstFile + 1 < argc) {
+            threads = atoi(argv[++firstFile]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (firstFile >= argc) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Aggregate agg;
+    if (!aggInit(&agg)) {
+        printf("Not enough memory.\n");
+        return 1;
+    }
+
+    double start = nowSeconds();
+    for (int i = firstFile; i < argc; i++) {
+        if (!aggFile(&agg, argv[i], threads)) {
+            fprintf(stderr, "Cannot read %s - skipped.\n", argv[i]);
+        }
+    }
+    double seconds = nowSeconds() - start;
+
+    if (json) {
+        aggPrintJson(stdout, &agg);
+    } else {
+        aggPrintTable(stdout, &agg);
+        printf("\nRead %.1f MB in %.3f s (%.0f MB/s)\n", (double)agg.bytes / 1e6, seconds,
+               seconds > 0 ? (double)agg.bytes / 1e6 / seconds : 0.0);
+    }
+    aggFree(&agg);
+    return 0;
+}
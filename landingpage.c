@@ -1,15 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include "gamecore.h"  // Shared game core - built into libgamecore by the Makefile
+
+// Opening banner, also kept above the board while the game runs
+static const char *openingPage =
+    "====================================\n"
+    "        TIK TAC TOK GAME             \n"
+    "    Designed by IT25100502           \n"
+    "====================================\n\n";
 
 void showOpeningPage() {
-    printf("====================================\n");
-    printf("        TIK TAC TOK GAME             \n");
-    printf("    Designed by IT25100502           \n");
-    printf("====================================\n\n");
+    printf("%s", openingPage);
 }
 
 int selectGameMode() {
-    int choice;
+    int choice = 0;
     printf("Please Select Game Mode:\n");
     printf("1. Player vs Player\n");
     printf("2. Player vs Computer\n");
@@ -20,34 +25,71 @@ int selectGameMode() {
 }
 
 int selectBoardSize() {
-    int size;
-    printf("\nSelect Board Size (3 to 10): ");
+    int size = 0;
+    printf("\nSelect Board Size (%d to %d): ", BOARD_MIN_SIZE, BOARD_MAX_SIZE);
     scanf("%d", &size);
 
-    if (size < 3 || size > 10) {
+    if (size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE) {
         printf("Invalid choice! Defaulting to 3x3.\n");
         size = 3;
     }
     return size;
 }
 
-int main() {
-    showOpeningPage();
+// Board display for the game loop - redraws only changed cells on a terminal
+static void displayBoard(void *screen, const Board *board) {
+    renderBoard((Renderer *)screen, board);
+}
+
+// Launcher: picks the mode and board size (menus, or --mode and --size) and
+// plays that game right here through the shared game loop. With --mode,
+// --size and --names nothing is asked at all; the game options of the other
+// programs (--engine, --time, --log-format, --simulate ...) work here too.
+int main(int argc, char *argv[]) {
+    GameOptions options;
+    if (!parseGameOptions(argc, argv, &options)) return 1;
 
-    int mode = selectGameMode();
-    int boardSize = selectBoardSize();
+    // --simulate: headless computer-vs-computer games, as in the game programs
+    if (options.simulateGames > 0) return simulateFromOptions(&options);
 
-    printf("\nYou selected: ");
-    switch(mode) {
-        case 1: printf("Player vs Player"); break;
-        case 2: printf("Player vs Computer"); break;
-        case 3: printf("Multiplayer"); break;
-        default: printf("Invalid mode, defaulting to Player vs Player"); mode = 1; break;
+    GameSetup setup;
+    if (!gameSetupFromOptions(&setup, &options)) return 1;
+
+    if (setup.mode == 0 || setup.size == 0) {
+        showOpeningPage();
+        if (setup.mode == 0) {
+            int mode = selectGameMode();
+            if (mode < 1 || mode > 3) {
+                printf("Invalid mode, defaulting to Player vs Player.\n");
+                mode = 1;
+            }
+            setup.mode = mode;
+        }
+        if (setup.size == 0) setup.size = selectBoardSize();
+
+        printf("\nYou selected: ");
+        switch (setup.mode) {
+            case 1: printf("Player vs Player"); break;
+            case 2: printf("Player vs Computer"); break;
+            case 3: printf("Multiplayer"); break;
+        }
+        if (setup.size == GAME_SIZE_UNBOUNDED) printf(" on an unbounded board.\n\n");
+        else printf(" on a %dx%d board.\n\n", setup.size, setup.size);
     }
 
-    printf(" on a %dx%d board.\n", boardSize, boardSize);
+    // Only the player names are left to ask (unless --names gave them)
+    if (!gameAskSetup(&setup)) return 1;
 
-    // TODO: Add game logic for selected mode and board size
+    const char *logName = (options.log.format == LOG_FORMAT_BINARY) ? "landingpage.bin" : "landingpage.txt";
+    GameLog *log = gameLogOpen(logName, 1, &options.log);  // 1 = append to the existing file
+    if (log == NULL) {
+        printf("Cannot open file.\n");
+        return 1;
+    }
 
-    return 0;
+    Renderer screen;
+    renderInit(&screen, openingPage);
+    int winner = gamePlay(&setup, &options.computer, log, displayBoard, &screen);
+    gameLogClose(log);
+    return winner == GAME_ABANDONED ? 1 : 0;
 }
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "board.h"
+#include "rng.h"
+#include "timer.h"
+
+// Load generator for server.c: each client thread connects to the server's
+// socket, keeps its share of the games open at once and plays random legal
+// moves in them round robin, checking every reply against its own copy of
+// the board. Reports moves per second and the time from sending a command to
+// its state line (mean and 99th percentile).
+
+#define LOADTEST_MAX_CLIENTS 1024
+#define LOADTEST_SAMPLES (1 << 16)   // Latencies kept per client for the percentile
+#define LOADTEST_LINE 1024
+
+typedef struct {
+    long long id;
+    Board board;
+} TestGame;
+
+typedef struct {
+    const char *socketPath;
+    int index;
+    int games, size, mode;
+    double seconds;
+    // Results
+    long long moves, finished, errors;
+    double latencySum;
+    long long commands;
+    int sampleCount;
+    float samples[LOADTEST_SAMPLES];
+    // Connection
+    int fd;
+    char in[LOADTEST_LINE * 4];
+    size_t inStart, inLength;
+    char line[LOADTEST_LINE];       // Last line read
+} TestClient;
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --socket PATH   Server socket (default: tictactoe.sock)\n");
+    printf("  --clients N     Connections, one thread each (default: 8)\n");
+    printf("  --games N       Games each client keeps open (default: 512)\n");
+    printf("  --size N        Board size (default: 3)\n");
+    printf("  --mode M        1 = the client plays both seats, 2 = against the server's computer (default: 1)\n");
+    printf("  --seconds S     Run time (default: 5)\n");
+}
+
+// Next reply line without the newline; NULL if the connection closed
+static const char *readLine(TestClient *client) {
+    char *line = client->line;
+    for (;;) {
+        char *start = client->in + client->inStart;
+        char *end = (char *)memchr(start, '\n', client->inLength);
+        if (end != NULL) {
+            size_t length = (size_t)(end - start);
+            if (length >= LOADTEST_LINE) length = LOADTEST_LINE - 1;
+            memcpy(line, start, length);
+            line[length] = '\0';
+            client->inStart += (size_t)(end - start) + 1;
+            client->inLength -= (size_t)(end - start) + 1;
+            return line;
+        }
+        memmove(client->in, start, client->inLength);
+        client->inStart = 0;
+        if (client->inLength == sizeof(client->in)) return NULL;
+        ssize_t n = recv(client->fd, client->in + client->inLength, sizeof(client->in) - client->inLength, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return NULL;
+        client->inLength += (size_t)n;
+    }
+}
+
+static int sendLine(TestClient *client, const char *line) {
+    size_t length = strlen(line);
+    while (length > 0) {
+        ssize_t n = send(client->fd, line, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        line += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+// Send command and read replies up to the state line, playing every MOVED
+// on game's board. Returns 0 if the connection failed.
+static int command(TestClient *client, TestGame *game, const char *text) {
+    double start = nowSeconds();
+    if (!sendLine(client, text)) return 0;
+    for (;;) {
+        const char *line = readLine(client);
+        if (line == NULL) return 0;
+        long long id;
+        int size, mode, row, col;
+        char symbol;
+        if (sscanf(line, "GAME %lld %d %d", &id, &size, &mode) == 3) {
+            game->id = id;
+            boardInit(&game->board, size, 2);
+        } else if (sscanf(line, "MOVED %lld %c %d %d", &id, &symbol, &row, &col) == 4) {
+            int player = game->board.moveCount % 2;
+            if (id != game->id || symbol != playerToSymbol(player) || !boardIsValidMove(&game->board, row - 1, col - 1)) {
+                client->errors++;
+            } else {
+                boardPlace(&game->board, row - 1, col - 1, player);
+                client->moves++;
+            }
+        } else if (strncmp(line, "WIN ", 4) == 0 || strncmp(line, "DRAW ", 5) == 0) {
+            if (game->board.winner < 0 && !boardIsDraw(&game->board)) client->errors++;
+            game->id = 0;
+            client->finished++;
+            break;
+        } else if (strncmp(line, "TURN ", 5) == 0) {
+            break;
+        } else {
+            client->errors++;  // ERR or anything unexpected ends the command
+            game->id = 0;
+            break;
+        }
+    }
+    double latency = nowSeconds() - start;
+    client->latencySum += latency;
+    client->commands++;
+    if (client->sampleCount < LOADTEST_SAMPLES) client->samples[client->sampleCount++] = (float)latency;
+    return 1;
+}
+
+static void *clientThread(void *arg) {
+    TestClient *client = (TestClient *)arg;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, client->socketPath, sizeof(address.sun_path) - 1);
+    client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client->fd < 0 || connect(client->fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        client->errors++;
+        return NULL;
+    }
+
+    TestGame *games = (TestGame *)calloc((size_t)client->games, sizeof(TestGame));
+    Rng rng;
+    rngSeed(&rng, rngStreamSeed(1, (uint64_t)client->index));
+    char text[64];
+    snprintf(text, sizeof(text), "NEW %d %d %s\n", client->size, client->mode, client->mode == 2 ? "Load" : "Load,Test");
+
+    double end = nowSeconds() + client->seconds;
+    int ok = games != NULL;
+    while (ok && nowSeconds() < end) {
+        for (int g = 0; g < client->games && ok; g++) {
+            TestGame *game = &games[g];
+            if (game->id == 0) {
+                ok = command(client, game, text);
+            } else {
+                int row, col;
+                boardRandomMove(&game->board, &rng, &row, &col);
+                char move[64];
+                snprintf(move, sizeof(move), "MOVE %lld %d %d\n", game->id, row + 1, col + 1);
+                ok = command(client, game, move);
+            }
+        }
+    }
+    if (!ok) client->errors++;
+    close(client->fd);
+    free(games);
+    return NULL;
+}
+
+static int compareFloats(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[]) {
+    const char *socketPath = "tictactoe.sock";
+    int clients = 8, games = 512, size = 3, mode = 1;
+    double seconds = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            clients = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+            mode = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (clients < 1 || clients > LOADTEST_MAX_CLIENTS || games < 1 || (mode != 1 && mode != 2) ||
+        size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    TestClient *jobs = (TestClient *)calloc((size_t)clients, sizeof(TestClient));
+    pthread_t *ids = (pthread_t *)calloc((size_t)clients, sizeof(pthread_t));
+    int *started = (int *)calloc((size_t)clients, sizeof(int));
+    if (jobs == NULL || ids == NULL || started == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+    double start = nowSeconds();
+    for (int c = 0; c < clients; c++) {
+        jobs[c].socketPath = socketPath;
+        jobs[c].index = c;
+        jobs[c].games = games;
+        jobs[c].size = size;
+        jobs[c].mode = mode;
+        jobs[c].seconds = seconds;
+        started[c] = pthread_create(&ids[c], NULL, clientThread, &jobs[c]) == 0;
+        if (!started[c]) clientThread(&jobs[c]);
+    }
+
+    long long moves = 0, finished = 0, errors = 0, commands = 0;
+    double latencySum = 0;
+    size_t sampleCount = 0;
+    for (int c = 0; c < clients; c++) {
+        if (started[c]) pthread_join(ids[c], NULL);
+        moves += jobs[c].moves;
+        finished += jobs[c].finished;
+        errors += jobs[c].errors;
+        commands += jobs[c].commands;
+        latencySum += jobs[c].latencySum;
+        sampleCount += (size_t)jobs[c].sampleCount;
+    }
+    double elapsed = nowSeconds() - start;
+
+    float *samples = (float *)malloc((sampleCount + 1) * sizeof(float));
+    size_t n = 0;
+    for (int c = 0; c < clients && samples != NULL; c++) {
+        memcpy(samples + n, jobs[c].samples, (size_t)jobs[c].sampleCount * sizeof(float));
+        n += (size_t)jobs[c].sampleCount;
+    }
+    double p99 = 0;
+    if (samples != NULL && n > 0) {
+        qsort(samples, n, sizeof(float), compareFloats);
+        p99 = samples[n * 99 / 100];
+    }
+
+    printf("%d clients x %d games (%d x %d, mode %d), %.1f s\n", clients, games, size, size, mode, elapsed);
+    printf("Commands: %lld (%.0f/s)   Moves: %lld (%.0f/s)   Games finished: %lld   Errors: %lld\n",
+           commands, commands / elapsed, moves, moves / elapsed, finished, errors);
+    printf("Latency: mean %.3f ms, p99 %.3f ms\n", commands > 0 ? latencySum / commands * 1e3 : 0.0, p99 * 1e3);
+    free(samples);
+    free(jobs);
+    free(ids);
+    free(started);
+    return errors > 0;
+}
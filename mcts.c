@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <math.h>
+#include "mcts.h"
+#include "timer.h"
+
+#define UCT_EXPLORATION 1.0f  // Exploration constant (rewards are 0 to 1)
+
+// One tree node. Children of a node sit next to each other in the arena.
+typedef struct {
+    int parent;                // Arena index of the parent (-1 for the root)
+    int firstChild;            // Arena index of the first child (-1 until expanded)
+    unsigned char childCount;
+    unsigned char move;        // Cell played to reach this node
+    unsigned char player;      // Player who played that move
+    unsigned char terminal;    // 1 once the move is known to end the game
+    unsigned int visits;
+    float reward;              // Total reward for player over all visits
+} MctsNode;
+
+struct MctsContext {
+    MctsNode *nodes;
+    int capacity;
+    int used;
+    Rng rng;  // Playout random numbers
+};
+
+MctsContext *mctsCreate(int maxNodes) {
+    MctsContext *mcts = (MctsContext *)calloc(1, sizeof(MctsContext));
+    if (mcts == NULL) return NULL;
+
+    mcts->nodes = (MctsNode *)malloc((size_t)maxNodes * sizeof(MctsNode));
+    if (mcts->nodes == NULL) {
+        free(mcts);
+        return NULL;
+    }
+    mcts->capacity = maxNodes;
+    rngSeed(&mcts->rng, 1);
+    return mcts;
+}
+
+void mctsSeed(MctsContext *mcts, uint64_t seed) {
+    rngSeed(&mcts->rng, seed);
+}
+
+void mctsDestroy(MctsContext *mcts) {
+    if (mcts == NULL) return;
+    free(mcts->nodes);
+    free(mcts);
+}
+
+// Give a node one child per empty cell; 0 if the arena has no room left
+static int expand(MctsContext *mcts, int index, const Board *board, int toMove) {
+    int empty = board->cells - board->moveCount;
+    if (mcts->used + empty > mcts->capacity) return 0;
+
+    MctsNode *node = &mcts->nodes[index];
+    node->firstChild = mcts->used;
+    node->childCount = (unsigned char)empty;
+
+    for (int cell = 0; cell < board->cells; cell++) {
+        if (bitTest(&board->occupied, cell)) continue;
+        MctsNode *child = &mcts->nodes[mcts->used++];
+        child->parent = index;
+        child->firstChild = -1;
+        child->childCount = 0;
+        child->move = (unsigned char)cell;
+        child->player = (unsigned char)toMove;
+        child->terminal = 0;
+        child->visits = 0;
+        child->reward = 0;
+    }
+    return 1;
+}
+
+// UCT: best average reward plus an exploration bonus; unvisited children first
+static int selectChild(const MctsContext *mcts, const MctsNode *node) {
+    float logVisits = logf((float)node->visits);
+    int best = node->firstChild;
+    float bestValue = -1.0f;
+
+    for (int i = 0; i < node->childCount; i++) {
+        int index = node->firstChild + i;
+        const MctsNode *child = &mcts->nodes[index];
+        if (child->visits == 0) return index;
+
+        float value = child->reward / child->visits +
+                      UCT_EXPLORATION * sqrtf(logVisits / child->visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = index;
+        }
+    }
+    return best;
+}
+
+// Play random moves until the game ends; returns the winner or -1 for a draw
+static int playout(Board *board, int toMove, Rng *rng) {
+    while (board->winner < 0 && !boardIsDraw(board)) {
+        int row, col;
+        boardRandomMove(board, rng, &row, &col);
+        boardPlace(board, row, col, toMove);
+        toMove = (toMove + 1) % board->players;
+    }
+    return board->winner;
+}
+
+// One iteration: select down the tree, expand a leaf, play out, back up the result
+static void iterate(MctsContext *mcts, const Board *root, int rootPlayer) {
+    Board board = *root;
+    int toMove = rootPlayer;
+    int index = 0;
+
+    // Selection: follow UCT through fully expanded nodes
+    while (mcts->nodes[index].firstChild >= 0 && !mcts->nodes[index].terminal) {
+        index = selectChild(mcts, &mcts->nodes[index]);
+        MctsNode *node = &mcts->nodes[index];
+        boardPlace(&board, node->move / board.size, node->move % board.size, toMove);
+        toMove = (toMove + 1) % board.players;
+        if (board.winner >= 0 || boardIsDraw(&board)) node->terminal = 1;
+    }
+
+    // Expansion: a leaf gets its children the second time it is reached
+    MctsNode *leaf = &mcts->nodes[index];
+    if (!leaf->terminal && (leaf->visits > 0 || index == 0) && expand(mcts, index, &board, toMove)) {
+        index = mcts->nodes[index].firstChild;
+        MctsNode *node = &mcts->nodes[index];
+        boardPlace(&board, node->move / board.size, node->move % board.size, toMove);
+        toMove = (toMove + 1) % board.players;
+        if (board.winner >= 0 || boardIsDraw(&board)) node->terminal = 1;
+    }
+
+    // Simulation on the stack copy - no allocation
+    int winner = playout(&board, toMove, &mcts->rng);
+
+    // Backpropagation: a win is worth 1 to the winner, a draw is shared
+    float drawReward = 1.0f / board.players;
+    while (index >= 0) {
+        MctsNode *node = &mcts->nodes[index];
+        node->visits++;
+        if (winner < 0) node->reward += drawReward;
+        else if (winner == node->player) node->reward += 1.0f;
+        index = node->parent;
+    }
+}
+
+void mctsSearch(MctsContext *mcts, const Board *board, int player, const MctsLimits *limits, MctsResult *result) {
+    double start = nowSeconds();
+    double deadline = (limits->timeLimit > 0) ? start + limits->timeLimit : 0;
+
+    // Fresh tree: the root is the current position
+    MctsNode *root = &mcts->nodes[0];
+    root->parent = -1;
+    root->firstChild = -1;
+    root->childCount = 0;
+    root->move = 0;
+    root->player = (unsigned char)((player + board->players - 1) % board->players);
+    root->terminal = 0;
+    root->visits = 0;
+    root->reward = 0;
+    mcts->used = 1;
+
+    long long playouts = 0;
+    do {
+        iterate(mcts, board, player);
+        playouts++;
+        if (limits->playouts > 0 && playouts >= limits->playouts) break;
+        if (limits->timeLimit <= 0 && limits->playouts <= 0) break;  // No limits given: one playout
+        if (limits->stop != NULL && atomic_load_explicit(limits->stop, memory_order_relaxed)) break;
+    } while (deadline == 0 || (playouts & 63) != 0 || nowSeconds() < deadline);
+
+    // Arena too small for even the root's children: fall back to a random move
+    if (root->firstChild < 0) {
+        boardRandomMove(board, &mcts->rng, &result->row, &result->col);
+        result->winRate = 0;
+        result->playouts = playouts;
+        result->treeNodes = mcts->used;
+        result->seconds = nowSeconds() - start;
+        result->playoutsPerSec = 0;
+        return;
+    }
+
+    // The most visited move is the most reliable one
+    int best = root->firstChild;
+    for (int i = 1; i < root->childCount; i++) {
+        if (mcts->nodes[root->firstChild + i].visits > mcts->nodes[best].visits) {
+            best = root->firstChild + i;
+        }
+    }
+
+    const MctsNode *chosen = &mcts->nodes[best];
+    result->row = chosen->move / board->size;
+    result->col = chosen->move % board->size;
+    result->winRate = chosen->visits ? chosen->reward / chosen->visits : 0;
+    result->playouts = playouts;
+    result->treeNodes = mcts->used;
+    result->seconds = nowSeconds() - start;
+    result->playoutsPerSec = (result->seconds > 0) ? playouts / result->seconds : 0;
+}
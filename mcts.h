@@ -0,0 +1,46 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stdatomic.h>
+#include "board.h"
+
+// Monte Carlo Tree Search (UCT) engine for the Computer player.
+// Works for 2 and 3 players: every node keeps the reward of the player who
+// made the move leading to it, so each player picks what is best for itself.
+// Tree nodes come from one preallocated arena and playouts run on stack
+// copies of the board, so a search does no allocation at all.
+
+#define MCTS_DEFAULT_NODES (1 << 20)  // Arena size: 1M nodes of 20 bytes (20 MB)
+#define MCTS_DEFAULT_PLAYOUTS 0       // 0 = only the time limit applies
+
+// Limits for one search - it stops at whichever is reached first
+typedef struct {
+    double timeLimit;    // Seconds per move (0 = no time limit)
+    long long playouts;  // Playouts per move (0 = no playout limit)
+    atomic_int *stop;    // Set to nonzero from another thread to end the search now (NULL = none)
+} MctsLimits;
+
+typedef struct {
+    int row, col;           // Chosen move (0-based)
+    double winRate;         // Average reward of the chosen move (0 to 1)
+    long long playouts;     // Random games played to the end
+    int treeNodes;          // Arena nodes used
+    double seconds;         // Wall-clock time used
+    double playoutsPerSec;  // playouts / seconds
+} MctsResult;
+
+typedef struct MctsContext MctsContext;
+
+// Create a search context whose tree can hold up to maxNodes nodes.
+// When the arena is full the search keeps running playouts without growing the tree.
+MctsContext *mctsCreate(int maxNodes);
+void mctsDestroy(MctsContext *mcts);
+
+// Seed the playout random numbers (same seed + same limits = same moves)
+void mctsSeed(MctsContext *mcts, uint64_t seed);
+
+// Pick a move for player on board (board must not be finished).
+// At least one playout is always run, even with tiny limits.
+void mctsSearch(MctsContext *mcts, const Board *board, int player, const MctsLimits *limits, MctsResult *result);
+
+#endif
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include "options.h"
+#include "bigboard.h"
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("Computer player:\n");
+    printf("  --threads N           Search threads, or games played side by side with --simulate (default: one per core)\n");
+    printf("  --time SECONDS        Thinking time per move (default: %.1f)\n", AI_DEFAULT_TIME);
+    printf("  --engine NAME         minimax, mcts or random (default: minimax)\n");
+    printf("  --playouts N          MCTS playouts per move (default: time limit only)\n");
+    printf("  --book FILE           Solved positions and opening moves from bookgen (default: %s, none = search only)\n",
+           BOOK_DEFAULT_PATH);
+    printf("Game setup (skips the menus):\n");
+    printf("  --size S              Board size (3 to 10; up to %d or \"infinite\" for a large board)\n", BIG_MAX_SIZE);
+    printf("  --mode M              1 = two players, 2 = vs computer, 3 = three players\n");
+    printf("  --names LIST          Player names, e.g. Alice,Bob (mode 3: a seat named Computer is the computer)\n");
+    printf("  --win-length K        Marks in a row that win, 3 to the board size\n");
+    printf("                        (default: a full line, or %d on a large board)\n", BIG_DEFAULT_WIN);
+    printf("Headless self-play:\n");
+    printf("  --simulate N          Play N games between computer agents and print statistics\n");
+    printf("  --players LIST        Agent per seat, e.g. random,random,ai (default: all random)\n");
+    printf("  --seed N              Random seed (default: current time)\n");
+    printf("  --depth D             Minimax depth per move (default: %d)\n", SIM_DEFAULT_DEPTH);
+    printf("  --log FILE            Record every simulated game in FILE\n");
+    printf("Game log:\n");
+    printf("  --log-format F        text, csv or binary (default: text)\n");
+    printf("  --log-flush WHEN      move, game or full - when buffered records reach the file\n");
+    printf("                        (default: game, or full with --simulate)\n");
+    printf("  --log-buffer KB       Log buffer size (default: %d KB)\n", GAMELOG_DEFAULT_BUFFER / 1024);
+    printf("  --log-thread 0|1      Write the log from a background thread (default: 0, or 1 with --simulate)\n");
+}
+
+// Parse value as a whole number from min to max - no trailing characters,
+// no overflow. Returns 0 if it is not one.
+static int parseNumber(const char *value, long long min, long long max, long long *out) {
+    char *end;
+    errno = 0;
+    long long number = strtoll(value, &end, 10);
+    if (end == value || *end != '\0' || errno == ERANGE || number < min || number > max) return 0;
+    *out = number;
+    return 1;
+}
+
+static int badValue(const char *program, const char *arg, const char *value) {
+    printf("Invalid value '%s' for %s.\n", value, arg);
+    printUsage(program);
+    return 0;
+}
+
+int parseGameOptions(int argc, char *argv[], GameOptions *opts) {
+    memset(opts, 0, sizeof(*opts));
+    computerDefaults(&opts->computer);
+    gameLogDefaults(&opts->log);
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        long long number;
+        if (value != NULL && strcmp(arg, "--threads") == 0) {
+            if (!parseNumber(value, 1, AI_MAX_THREADS, &number)) return badValue(argv[0], arg, value);
+            opts->computer.threads = (int)number;
+        } else if (value != NULL && strcmp(arg, "--time") == 0) {
+            char *end;
+            double seconds = strtod(value, &end);
+            if (end == value || *end != '\0' || !(seconds >= 0)) return badValue(argv[0], arg, value);
+            opts->computer.timeLimit = seconds;
+            opts->timeGiven = 1;
+        } else if (value != NULL && strcmp(arg, "--engine") == 0) {
+            if (!parseEngine(value, &opts->computer.engine)) {
+                printf("Unknown engine '%s'.\n", value);
+                return 0;
+            }
+        } else if (value != NULL && strcmp(arg, "--playouts") == 0) {
+            if (!parseNumber(value, 0, LLONG_MAX, &number)) return badValue(argv[0], arg, value);
+            opts->computer.playouts = number;
+            opts->playoutsGiven = 1;
+        } else if (value != NULL && strcmp(arg, "--book") == 0) {
+            opts->computer.bookPath = (strcmp(value, "none") == 0) ? NULL : value;
+        } else if (value != NULL && strcmp(arg, "--simulate") == 0) {
+            if (!parseNumber(value, 1, LLONG_MAX, &number)) return badValue(argv[0], arg, value);
+            opts->simulateGames = number;
+        } else if (value != NULL && strcmp(arg, "--size") == 0) {
+            if (strcmp(value, "infinite") == 0) {
+                opts->size = GAME_SIZE_UNBOUNDED;
+            } else if (parseNumber(value, BOARD_MIN_SIZE, BIG_MAX_SIZE, &number)) {
+                opts->size = (int)number;
+            } else {
+                return badValue(argv[0], arg, value);
+            }
+        } else if (value != NULL && strcmp(arg, "--mode") == 0) {
+            if (!parseNumber(value, 1, 3, &number)) return badValue(argv[0], arg, value);
+            opts->mode = (int)number;
+        } else if (value != NULL && strcmp(arg, "--win-length") == 0) {
+            if (!parseNumber(value, BOARD_MIN_SIZE, BIG_MAX_SIZE, &number)) return badValue(argv[0], arg, value);
+            opts->winLength = (int)number;
+        } else if (value != NULL && strcmp(arg, "--names") == 0) {
+            opts->names = value;
+        } else if (value != NULL && strcmp(arg, "--players") == 0) {
+            opts->players = value;
+        } else if (value != NULL && strcmp(arg, "--seed") == 0) {
+            if (!parseNumber(value, 0, UINT_MAX, &number)) return badValue(argv[0], arg, value);
+            opts->seed = (unsigned int)number;
+            opts->seedGiven = 1;
+        } else if (value != NULL && strcmp(arg, "--depth") == 0) {
+            if (!parseNumber(value, 1, BOARD_MAX_CELLS, &number)) return badValue(argv[0], arg, value);
+            opts->depth = (int)number;
+        } else if (value != NULL && strcmp(arg, "--log") == 0) {
+            opts->logPath = value;
+        } else if (value != NULL && strcmp(arg, "--log-format") == 0) {
+            if (!parseLogFormat(value, &opts->log.format)) {
+                printf("Unknown log format '%s'.\n", value);
+                return 0;
+            }
+        } else if (value != NULL && strcmp(arg, "--log-flush") == 0) {
+            if (!parseLogFlush(value, &opts->log.flush)) {
+                printf("Unknown log flush policy '%s'.\n", value);
+                return 0;
+            }
+            opts->logFlushGiven = 1;
+        } else if (value != NULL && strcmp(arg, "--log-buffer") == 0) {
+            if (!parseNumber(value, 1, 1 << 20, &number)) return badValue(argv[0], arg, value);  // Up to 1 GB
+            opts->log.bufferSize = (size_t)number * 1024;
+        } else if (value != NULL && strcmp(arg, "--log-thread") == 0) {
+            if (!parseNumber(value, 0, 1, &number)) return badValue(argv[0], arg, value);
+            opts->log.background = (int)number;
+            opts->logThreadGiven = 1;
+        } else {
+            printUsage(argv[0]);
+            return 0;
+        }
+        i++;  // Every option takes one value
+    }
+    return 1;
+}
+
+int simConfigFromOptions(const GameOptions *opts, SimConfig *cfg) {
+    simDefaults(cfg);
+    cfg->games = opts->simulateGames;
+    if (opts->size != 0) cfg->size = opts->size;
+    if (opts->mode != 0) cfg->mode = opts->mode;
+    cfg->winLength = opts->winLength;
+    cfg->players = (cfg->mode == 3) ? 3 : 2;
+    cfg->seed = opts->seedGiven ? opts->seed : (unsigned int)time(NULL);
+    cfg->threads = opts->computer.threads;  // --threads: worker threads for the simulation
+    cfg->logPath = opts->logPath;
+    cfg->log.format = opts->log.format;
+    cfg->log.bufferSize = opts->log.bufferSize;
+    if (opts->logFlushGiven) cfg->log.flush = opts->log.flush;
+    if (opts->logThreadGiven) cfg->log.background = opts->log.background;
+
+    if (cfg->size < BOARD_MIN_SIZE || cfg->size > BOARD_MAX_SIZE) {
+        printf("Wrong size.\n");
+        return 0;
+    }
+    if (cfg->winLength != 0 && (cfg->winLength < BOARD_MIN_SIZE || cfg->winLength > cfg->size)) {
+        printf("Wrong win length.\n");
+        return 0;
+    }
+    if (cfg->mode < 1 || cfg->mode > 3) {
+        printf("Wrong mode.\n");
+        return 0;
+    }
+    if (opts->players != NULL && simParsePlayers(opts->players, cfg) != cfg->players) {
+        printf("--players needs %d agents (random, ai/minimax or mcts) for mode %d.\n", cfg->players, cfg->mode);
+        return 0;
+    }
+
+    // Explicit budgets on the command line override the simulation defaults
+    for (int i = 0; i < cfg->players; i++) {
+        if (opts->depth > 0) cfg->agents[i].maxDepth = opts->depth;
+        if (opts->timeGiven) cfg->agents[i].timeLimit = opts->computer.timeLimit;
+        if (opts->playoutsGiven) cfg->agents[i].playouts = opts->computer.playouts;
+    }
+    return 1;
+}
+
+int simulateFromOptions(const GameOptions *opts) {
+    SimConfig sim;
+    SimStats stats;
+    if (!simConfigFromOptions(opts, &sim)) return 1;
+    if (!runSimulation(&sim, &stats)) {
+        printf("Cannot set up the computer players or the log file.\n");
+        return 1;
+    }
+    printSimStats(stdout, &sim, &stats);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "computer.h"
+#include "simulate.h"
+#include "gamelog.h"
+
+// Command-line options shared by the game programs:
+//   --threads N --time SECONDS --engine NAME --playouts N --book FILE  (computer player)
+//   --size S --mode M --names LIST --win-length K            (game setup, skips the menus)
+//                          S above 10 (or "infinite") plays on a large board
+//   --simulate N --players LIST --seed N --depth D           (headless self-play)
+//   --log FILE --log-format F --log-flush WHEN --log-buffer KB --log-thread 0/1  (game log)
+
+#define GAME_SIZE_UNBOUNDED -1  // --size infinite: a board with no edges
+
+typedef struct {
+    ComputerSettings computer;  // Computer player for interactive games
+    long long simulateGames;    // 0 = play an interactive game
+    int size;                   // 0 = not given, GAME_SIZE_UNBOUNDED = no edges
+    int mode;                   // 0 = not given
+    int winLength;              // Marks in a row that win, 0 = the full line
+    const char *names;          // Comma-separated player names, NULL = ask
+    const char *players;        // Seat list for --simulate, NULL = all random
+    unsigned int seed;
+    int seedGiven;
+    int depth;                  // Minimax depth for --simulate, 0 = default
+    int timeGiven;
+    int playoutsGiven;
+    GameLogSettings log;        // How games are written to the log file
+    const char *logPath;        // --log: record simulated games, NULL = no log
+    int logFlushGiven;
+    int logThreadGiven;
+} GameOptions;
+
+// Parse argv into opts; prints usage and returns 0 on a bad option
+int parseGameOptions(int argc, char *argv[], GameOptions *opts);
+
+// Build a simulation config from the options; prints the problem and returns 0 if invalid
+int simConfigFromOptions(const GameOptions *opts, SimConfig *cfg);
+
+// --simulate for every front end: play opts->simulateGames headless games
+// and print the statistics. Returns the program's exit status - 1 if the
+// options are invalid or the players or log file cannot be set up.
+int simulateFromOptions(const GameOptions *opts);
+
+#endif
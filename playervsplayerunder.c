@@ -1,57 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
-
-// This function creates an empty N x N game board using dynamic memory.
-// It allocates space for the board and fills it with spaces (' ').
-char** initBoard(int N) {
-    // Allocate memory for rows (an array of pointers)
-    char** board = (char**)malloc(N * sizeof(char*));
-    if (board == NULL) {  // Check if memory allocation failed
-        printf("Error: Could not allocate memory for the board.\n");
-        exit(1);  // Stop the program if there's an error
-    }
-    
-    // For each row, allocate memory for columns and fill with spaces
-    for (int i = 0; i < N; i++) {
-        board[i] = (char*)malloc(N * sizeof(char));
-        if (board[i] == NULL) {  // Check for allocation error
-            printf("Error: Could not allocate memory for row %d.\n", i);
-            exit(1);
-        }
-        // Initialize each cell to empty space
-        for (int j = 0; j < N; j++) {
-            board[i][j] = ' ';  // ' ' means empty cell
-        }
-    }
-    return board;  // Return the created board
-}
+#include "gamecore.h"  // Shared game core - built into libgamecore by the Makefile
 
 // This function prints the current state of the board to the screen.
 // It shows row and column numbers for easy input (1-based indexing).
-void displayBoard(char** board, int N) {
-    // Print column numbers at the top (1 to N)
-    printf("  ");  // Two spaces for alignment
-    for (int j = 1; j <= N; j++) {
-        printf("%2d", j);  // Print each column number with 2 spaces width
-    }
-    printf("\n");  // New line after headers
-
-    // Print each row of the board
-    for (int i = 1; i <= N; i++) {
-        printf("%2d", i);  // Print row number (1-based)
-        for (int j = 0; j < N; j++) {
-            printf("%2c", board[i - 1][j]);  // Print cell content (0-based index)
-        }
-        printf("\n");  // New line after each row
-    }
-    printf("\n");  // Extra space after the board
+void displayBoard(const Board* board) {
+    renderPrint(board, RENDER_COMPACT);  // Column numbers on top, row numbers on the left
 }
 
 // This function asks a player for their move (row and column).
 // It keeps asking until a valid move is entered.
 // Parameters: row and col will be updated with the player's choice.
-void getMove(int* row, int* col, char** board, int N, char player) {
+void getMove(int* row, int* col, const Board* board, char player) {
+    int N = board->size;
     int r, c;  // Temporary variables for row and column input
     printf("It's your turn, Player %c!\n", player);
     
@@ -82,7 +44,7 @@ void getMove(int* row, int* col, char** board, int N, char player) {
         }
 
         // Check if the chosen cell is already taken
-        if (board[r - 1][c - 1] != ' ') {
+        if (!boardIsValidMove(board, r - 1, c - 1)) {
             printf("Sorry, that cell is already taken! Choose an empty cell.\n");
             continue;
         }
@@ -96,115 +58,24 @@ void getMove(int* row, int* col, char** board, int N, char player) {
     *col = c;
 }
 
-// This function checks if a move is valid (in bounds and empty cell).
-// It returns true if valid, false otherwise.
-bool isValidMove(int row, int col, char** board, int N) {
-    // Check if row and column are within 1 to N
-    if (row < 1 || row > N || col < 1 || col > N) {
-        return false;
-    }
-    // Check if the cell is empty
-    if (board[row - 1][col - 1] != ' ') {
-        return false;
-    }
-    return true;  // Valid if both checks pass
-}
-
 // This function places the player's mark ('X' or 'O') on the board.
-void makeMove(char** board, int row, int col, char player) {
-    board[row - 1][col - 1] = player;  // Place mark (convert to 0-based index)
+void makeMove(Board* board, int row, int col, char player) {
+    boardPlace(board, row - 1, col - 1, symbolToPlayer(player));  // Place mark (convert to 0-based index)
     printf("You placed %c at row %d, column %d.\n", player, row, col);
 }
 
-// This function checks if the current player has won.
-// It checks all rows, columns, and both diagonals for a full line of the player's mark.
-bool checkWin(char** board, int N, char player) {
-    // Step 1: Check all rows
-    for (int i = 0; i < N; i++) {  // For each row
-        bool rowFull = true;  // Assume the row is full of player's marks
-        for (int j = 0; j < N; j++) {  // Check each cell in the row
-            if (board[i][j] != player) {
-                rowFull = false;  // Not full if any cell doesn't match
-                break;  // No need to check further
-            }
-        }
-        if (rowFull) {
-            return true;  // Win found!
-        }
-    }
-
-    // Step 2: Check all columns
-    for (int j = 0; j < N; j++) {  // For each column
-        bool colFull = true;  // Assume the column is full
-        for (int i = 0; i < N; i++) {  // Check each cell in the column
-            if (board[i][j] != player) {
-                colFull = false;
-                break;
-            }
-        }
-        if (colFull) {
-            return true;
-        }
-    }
-
-    // Step 3: Check main diagonal (top-left to bottom-right)
-    bool mainDiagFull = true;
-    for (int i = 0; i < N; i++) {
-        if (board[i][i] != player) {
-            mainDiagFull = false;
-            break;
-        }
-    }
-    if (mainDiagFull) {
-        return true;
-    }
-
-    // Step 4: Check anti-diagonal (top-right to bottom-left)
-    bool antiDiagFull = true;
-    for (int i = 0; i < N; i++) {
-        if (board[i][N - 1 - i] != player) {
-            antiDiagFull = false;
-            break;
-        }
-    }
-    if (antiDiagFull) {
-        return true;
-    }
-
-    // No win found
-    return false;
-}
-
-// This function checks if the game is a draw (board full with no winner).
-// It returns true if every cell is filled (no empty spaces).
-bool isDraw(char** board, int N) {
-    // Loop through all cells
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (board[i][j] == ' ') {  // If any empty cell found
-                return false;  // Not a draw yet
-            }
-        }
-    }
-    return true;  // All cells filled = draw
-}
-
 // This function writes the current board state to a log file.
 // It logs after each move for history.
-void logBoard(char** board, int N, FILE* logf, int moveNum, char player) {
+// Records go into the log's memory buffer; the file is written in one batch.
+void logBoard(const Board* board, GameLog* logf, int moveNum, char player) {
     if (logf == NULL) {  // If file can't be opened, skip logging
         return;
     }
     // Write header for this move
-    fprintf(logf, "After move #%d by Player %c:\n", moveNum, player);
-    // Write the board row by row
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            fprintf(logf, "%c ", board[i][j]);  // Print cell with space
-        }
-        fprintf(logf, "\n");  // New line after each row
-    }
-    fprintf(logf, "------------------------\n\n");  // Separator for next move
+    gameLogPrintf(logf, "After move #%d by Player %c:\n", moveNum, player);
+    // Write the board row by row ("X O   " - each cell followed by a space)
+    gameLogGrid(logf, board);
+    gameLogPrintf(logf, "------------------------\n\n");  // Separator for next move
 }
 
 // Main function: Sets up the game and runs the main loop.
@@ -223,25 +94,23 @@ int main() {
     }
     printf("Great! We'll play on a %d x %d board.\n\n", N, N);
 
-    // Create the empty board
-    char** board = initBoard(N);
+    // Create the empty board (one contiguous bitboard, no allocation needed)
+    Board board;
+    boardInit(&board, N, 2);
     
     // Open the log file for writing (creates 'game.log' if it doesn't exist)
-    FILE* logf = fopen("game.log", "w");  // "w" means write mode
+    GameLogSettings logSettings;
+    gameLogDefaults(&logSettings);  // Human-readable text, written out at the end of the game
+    GameLog* logf = gameLogOpen("game.log", 0, &logSettings);  // 0 = start a new file
     if (logf == NULL) {
         printf("Warning: Could not create log file 'game.log'. Continuing without logging.\n");
     } else {
         // Log the initial empty board
-        fprintf(logf, "=== TIC-TAC-TOE GAME LOG ===\n");
-        fprintf(logf, "Grid size: %d x %d\n\n", N, N);
-        fprintf(logf, "Initial empty board:\n");
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                fprintf(logf, "%c ", board[i][j]);
-            }
-            fprintf(logf, "\n");
-        }
-        fprintf(logf, "------------------------\n\n");
+        gameLogPrintf(logf, "=== TIC-TAC-TOE GAME LOG ===\n");
+        gameLogPrintf(logf, "Grid size: %d x %d\n\n", N, N);
+        gameLogPrintf(logf, "Initial empty board:\n");
+        gameLogGrid(logf, &board);
+        gameLogPrintf(logf, "------------------------\n\n");
     }
 
     // Game variables
@@ -255,31 +124,31 @@ int main() {
     // Main game loop: Continues until win or draw
     while (!gameOver) {
         // Show the current board
-        displayBoard(board, N);
+        displayBoard(&board);
 
         // Get the move from the current player
         int row, col;
-        getMove(&row, &col, board, N, currentPlayer);
+        getMove(&row, &col, &board, currentPlayer);
 
         // Place the mark on the board
-        makeMove(board, row, col, currentPlayer);
+        makeMove(&board, row, col, currentPlayer);
         moveNum++;  // Increment move count
 
         // Log this move to file
-        logBoard(board, N, logf, moveNum, currentPlayer);
+        logBoard(&board, logf, moveNum, currentPlayer);
 
         // Check if current player won
-        if (checkWin(board, N, currentPlayer)) {
-            displayBoard(board, N);  // Show final board
+        if (boardCheckWin(&board, symbolToPlayer(currentPlayer))) {
+            displayBoard(&board);  // Show final board
             printf("Congratulations! Player %c wins the game!\n", currentPlayer);
             gameOver = true;
             break;  // End the game
         }
 
-        // Check if it's a draw (board full)
-        if (isDraw(board, N)) {
-            displayBoard(board, N);  // Show final board
-            printf("The board is full with no winner. It's a draw!\n");
+        // Check if it's a draw (board full or no line left to win)
+        if (boardIsDraw(&board)) {
+            displayBoard(&board);  // Show final board
+            printf("Nobody can complete a line any more. It's a draw!\n");
             gameOver = true;
             break;
         }
@@ -296,14 +165,8 @@ int main() {
     printf("\nGame Over! Thanks for playing.\n");
     if (logf != NULL) {
         printf("Check the file 'game.log' to see the full move history.\n");
-        fclose(logf);  // Close the log file
-    }
-
-    // Clean up: Free all allocated memory to avoid memory leaks
-    for (int i = 0; i < N; i++) {
-        free(board[i]);  // Free each row
+        gameLogClose(logf);  // Write out and close the log file
     }
-    free(board);  // Free the array of row pointers
 
     return 0;  // Successful program end
 }
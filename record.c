@@ -0,0 +1,159 @@
+#include <string.h>
+#include "record.h"
+
+static void putU32(unsigned char *out, uint32_t value) {
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+static uint32_t getU32(const unsigned char *in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+void recordFileHeader(unsigned char out[RECORD_FILE_HEADER]) {
+    memcpy(out, RECORD_MAGIC, 4);
+    out[4] = (unsigned char)RECORD_VERSION;
+    out[5] = (unsigned char)(RECORD_VERSION >> 8);
+    out[6] = 0;
+    out[7] = 0;
+}
+
+int recordFileVersion(const unsigned char header[RECORD_FILE_HEADER]) {
+    if (memcmp(header, RECORD_MAGIC, 4) != 0) return 0;
+    return header[4] | header[5] << 8;
+}
+
+size_t recordEncode(const GameRecord *record, unsigned char *out) {
+    out[0] = (unsigned char)record->size;
+    out[1] = (unsigned char)record->mode;
+    out[2] = (unsigned char)record->players;
+    out[3] = record->winner >= 0 ? (unsigned char)record->winner : RECORD_DRAW;
+    out[4] = (unsigned char)record->moveCount;
+    out[5] = record->winLength < record->size ? (unsigned char)record->winLength : 0;
+    out[6] = out[7] = 0;
+    putU32(out + 8, record->seed);
+    putU32(out + 12, record->number);
+    memcpy(out + RECORD_HEADER, record->moves, (size_t)record->moveCount);
+    return RECORD_HEADER + (size_t)record->moveCount;
+}
+
+long recordDecode(const unsigned char *data, size_t available, int version, GameRecord *record) {
+    if (available < RECORD_HEADER) return 0;
+
+    int size = data[0], players = data[2], winner = data[3], moveCount = data[4];
+    int winLength = (version >= 2 && data[5] != 0) ? data[5] : size;  // Version 1: reserved, full line
+    if (size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE || players < 2 || players > BOARD_MAX_PLAYERS ||
+        winLength < BOARD_MIN_SIZE || winLength > size ||
+        moveCount > size * size || (winner != RECORD_DRAW && winner >= players)) {
+        return -1;
+    }
+    if (available < (size_t)(RECORD_HEADER + moveCount)) return 0;
+
+    record->size = size;
+    record->winLength = winLength;
+    record->mode = data[1];
+    record->players = players;
+    record->winner = (winner == RECORD_DRAW) ? -1 : winner;
+    record->moveCount = moveCount;
+    record->seed = getU32(data + 8);
+    record->number = getU32(data + 12);
+    for (int i = 0; i < BOARD_MAX_PLAYERS; i++) record->names[i] = NULL;
+    memcpy(record->moves, data + RECORD_HEADER, (size_t)moveCount);
+    return RECORD_HEADER + moveCount;
+}
+
+int recordReaderOpen(RecordReader *reader, const char *path) {
+    unsigned char header[RECORD_FILE_HEADER];
+
+    reader->file = fopen(path, "rb");
+    if (reader->file == NULL) return 0;
+    if (fread(header, 1, sizeof(header), reader->file) != sizeof(header) || recordFileVersion(header) == 0) {
+        fclose(reader->file);
+        reader->file = NULL;
+        return 0;
+    }
+    reader->version = recordFileVersion(header);
+    if (reader->version > RECORD_VERSION) {  // Written by a newer program
+        fclose(reader->file);
+        reader->file = NULL;
+        return 0;
+    }
+    reader->offset = RECORD_FILE_HEADER;
+    return 1;
+}
+
+void recordReaderClose(RecordReader *reader) {
+    if (reader->file != NULL) fclose(reader->file);
+    reader->file = NULL;
+}
+
+int recordRead(RecordReader *reader, GameRecord *record) {
+    unsigned char data[RECORD_MAX_BYTES];
+
+    size_t got = fread(data, 1, RECORD_HEADER, reader->file);
+    if (got == 0) return 0;
+    if (got < RECORD_HEADER) return -1;
+
+    size_t moves = data[4];
+    if (moves > BOARD_MAX_CELLS || fread(data + RECORD_HEADER, 1, moves, reader->file) != moves) return -1;
+    long used = recordDecode(data, RECORD_HEADER + moves, reader->version, record);
+    if (used <= 0) return -1;
+    reader->offset += used;
+    return 1;
+}
+
+int recordReplay(const GameRecord *record, int moves, Board *board) {
+    boardInitRule(board, record->size, record->players, record->winLength);
+    if (moves > record->moveCount) moves = record->moveCount;
+
+    for (int i = 0; i < moves; i++) {
+        int cell = record->moves[i];
+        int row = cell / record->size, col = cell % record->size;
+        if (!boardIsValidMove(board, row, col)) return i;
+        boardPlace(board, row, col, i % record->players);
+    }
+    return moves;
+}
+
+ReplayStatus recordCheck(const GameRecord *record, int *badMove) {
+    Board board;
+    boardInitRule(&board, record->size, record->players, record->winLength);
+    ReplayStatus status = REPLAY_OK;
+    int i = 0;
+
+    // One pass: every move must be legal and only the last one may win
+    for (; i < record->moveCount; i++) {
+        int cell = record->moves[i];
+        int row = cell / record->size, col = cell % record->size;
+        if (!boardIsValidMove(&board, row, col)) {
+            status = REPLAY_BAD_MOVE;
+            break;
+        }
+        boardPlace(&board, row, col, i % record->players);
+        if (board.winner >= 0 && i + 1 < record->moveCount) {
+            status = REPLAY_AFTER_WIN;
+            i++;
+            break;
+        }
+    }
+    if (status == REPLAY_OK) {
+        if (board.winner >= 0 ? board.winner != record->winner : record->winner >= 0 || !boardIsDraw(&board)) {
+            status = REPLAY_WRONG_RESULT;  // Wrong winner, claimed win that never happened, or unfinished game
+            i = record->moveCount - (board.winner >= 0);
+        }
+    }
+    if (badMove != NULL) *badMove = i;
+    return status;
+}
+
+const char *replayStatusName(ReplayStatus status) {
+    switch (status) {
+        case REPLAY_OK:           return "ok";
+        case REPLAY_BAD_MOVE:     return "illegal move";
+        case REPLAY_AFTER_WIN:    return "moves after the game was won";
+        case REPLAY_WRONG_RESULT: return "result does not match the moves";
+    }
+    return "unknown";
+}
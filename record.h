@@ -0,0 +1,93 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "board.h"
+
+// Binary game records: a compact, versioned file format that stores only
+// the moves of each game. Written by the game log (LOG_FORMAT_BINARY in
+// gamelog.h) and read back with the reader below.
+//
+// File layout (all numbers little-endian):
+//   File header, 8 bytes:  "TTTB", uint16 version, uint16 reserved (0)
+//   Then one record per game:
+//     16-byte header:  uint8 size, uint8 mode, uint8 players,
+//                      uint8 winner (0-2, 0xFF = draw), uint8 moveCount,
+//                      uint8 win length (0 = the full line), 2 reserved
+//                      bytes (0), uint32 seed, uint32 game number
+//     moveCount bytes: cell (row * size + col) of every move in order
+// A 3 x 3 game takes about 24 bytes against about 370 as text.
+// Version 1 had no win length: byte 5 was reserved and every game used the
+// full-line rule. Version 1 files are still read; readers refuse files from
+// a newer version rather than misread them.
+
+#define RECORD_MAGIC "TTTB"
+#define RECORD_VERSION 2
+#define RECORD_FILE_HEADER 8                                  // Bytes before the first record
+#define RECORD_HEADER 16                                      // Fixed part of every record
+#define RECORD_MAX_BYTES (RECORD_HEADER + BOARD_MAX_CELLS)    // Largest possible record
+#define RECORD_DRAW 0xFF                                      // Winner byte of a drawn game
+
+// One finished game
+typedef struct {
+    int size;                               // Board size
+    int winLength;                          // Marks in a row that win (size = the full line)
+    int mode;                               // Game mode as in the menu (1, 2 or 3)
+    int players;                            // 2 or 3
+    const char *names[BOARD_MAX_PLAYERS];   // Name of each seat (not stored in binary records)
+    unsigned int seed;                      // Seed of the run that played it (0 = unknown)
+    unsigned int number;                    // Game number within that run
+    int moveCount;
+    unsigned char moves[BOARD_MAX_CELLS];   // Cell (row * size + col) of every move in order
+    int winner;                             // Winning seat, -1 for a draw
+} GameRecord;
+
+// The 8-byte file header for the current version
+void recordFileHeader(unsigned char out[RECORD_FILE_HEADER]);
+
+// Encode record into out (RECORD_MAX_BYTES is always enough); returns bytes used
+size_t recordEncode(const GameRecord *record, unsigned char *out);
+
+// Version from a file header (0 if it is not a record file header)
+int recordFileVersion(const unsigned char header[RECORD_FILE_HEADER]);
+
+// Decode the record at data (available bytes) from a file of the given
+// version. Returns bytes consumed, 0 if the data ends inside the record, or
+// -1 if the record is invalid.
+long recordDecode(const unsigned char *data, size_t available, int version, GameRecord *record);
+
+// Sequential reader over a record file
+typedef struct {
+    FILE *file;
+    int version;          // Version from the file header
+    long long offset;     // File offset of the next record
+} RecordReader;
+
+// Open path and check its header; returns 0 if it cannot be read or is not a record file
+int recordReaderOpen(RecordReader *reader, const char *path);
+void recordReaderClose(RecordReader *reader);
+
+// Read the next record: 1 = read, 0 = end of file, -1 = truncated or corrupt
+int recordRead(RecordReader *reader, GameRecord *record);
+
+// Outcome of checking a record against the rules
+typedef enum {
+    REPLAY_OK,            // Every move legal and the stored result matches the board
+    REPLAY_BAD_MOVE,      // A move is off the board or on an occupied cell
+    REPLAY_AFTER_WIN,     // Moves continue after someone completed a line
+    REPLAY_WRONG_RESULT   // The final position does not give the stored result
+} ReplayStatus;
+
+// Set up board for the record and play its first moves moves (all of them
+// if moves is larger), checking each one like boardIsValidMove. Stops at the
+// first bad move; returns how many moves were played.
+int recordReplay(const GameRecord *record, int moves, Board *board);
+
+// Replay the whole game and compare with the stored result. On a failure
+// *badMove (if not NULL) is the 0-based move where it shows up. Drawn games
+// may run on to a full board, as logs from before the dead-line draw rule do.
+ReplayStatus recordCheck(const GameRecord *record, int *badMove);
+const char *replayStatusName(ReplayStatus status);
+
+#endif
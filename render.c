@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "render.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#define STDOUT_FD 1
+#define writeFd(fd, data, length) _write(fd, data, (unsigned int)(length))
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#else
+#include <unistd.h>
+#include <sys/ioctl.h>
+#define STDOUT_FD STDOUT_FILENO
+#define writeFd(fd, data, length) write(fd, data, length)
+#endif
+
+#define FRAME_BYTES 8192    // A full 10 x 10 frame with header is about 1.2 KB
+#define PROMPT_LINES 8      // Lines kept free below the board for prompts and messages
+
+typedef struct {
+    char data[FRAME_BYTES];
+    size_t length;
+} Frame;
+
+static void put(Frame *frame, const char *text, size_t length) {
+    if (frame->length + length > sizeof(frame->data)) length = sizeof(frame->data) - frame->length;
+    memcpy(frame->data + frame->length, text, length);
+    frame->length += length;
+}
+
+static void putText(Frame *frame, const char *text) {
+    put(frame, text, strlen(text));
+}
+
+// Move the cursor to row, col (1-based)
+static void putCursor(Frame *frame, int row, int col) {
+    char escape[24];
+    int length = snprintf(escape, sizeof(escape), "\x1b[%d;%dH", row, col);
+    put(frame, escape, (size_t)length);
+}
+
+// Hand the frame to the terminal in one system call (after anything printf left buffered)
+static void flushFrame(const Frame *frame) {
+    const char *data = frame->data;
+    size_t left = frame->length;
+
+    fflush(stdout);
+    while (left > 0) {
+        long written = (long)writeFd(STDOUT_FD, data, left);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return;
+        data += written;
+        left -= (size_t)written;
+    }
+}
+
+static int terminalRows(void) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) return 0;
+    return info.srWindow.Bottom - info.srWindow.Top + 1;
+#else
+    struct winsize ws;
+    if (ioctl(STDOUT_FD, TIOCGWINSZ, &ws) != 0) return 0;
+    return ws.ws_row;
+#endif
+}
+
+void renderInit(Renderer *renderer, const char *header) {
+    memset(renderer, 0, sizeof(*renderer));
+    renderer->header = header;
+    for (const char *c = header; c != NULL && *c != '\0'; c++) {
+        renderer->headerLines += (*c == '\n');
+    }
+#ifdef _WIN32
+    DWORD mode;
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    renderer->ansi = _isatty(STDOUT_FD) && GetConsoleMode(out, &mode) &&
+                     SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+    renderer->ansi = isatty(STDOUT_FD);
+#endif
+}
+
+void renderClear(Renderer *renderer) {
+    renderer->onScreen = 0;
+    if (!renderer->ansi) return;
+    Frame frame;
+    frame.length = 0;
+    putText(&frame, "\x1b[H\x1b[2J");
+    flushFrame(&frame);
+}
+
+// Screen line (1-based) of board row i in a full frame
+static int cellLine(const Renderer *renderer, int i) {
+    return renderer->headerLines + 3 + 2 * i;
+}
+
+// Screen column (1-based) of the symbol in board column j
+static int cellColumn(int j) {
+    return 7 + 4 * j;
+}
+
+// Row or column number n (1 to 99) right-aligned in two characters, like "%2d"
+static void number2(char *out, int n) {
+    out[0] = n >= 10 ? (char)('0' + n / 10) : ' ';
+    out[1] = (char)('0' + n % 10);
+}
+
+// The boxed grid: column numbers, "+---+" borders and "| X |" cells
+static void putBoxed(Frame *frame, const Board *board) {
+    int size = board->size;
+    char line[8 + 4 * BOARD_MAX_SIZE];
+    char border[8 + 4 * BOARD_MAX_SIZE];
+
+    // "    +---+---+ ... +" between rows
+    memcpy(border, "    ", 4);
+    for (int j = 0; j < size; j++) memcpy(border + 4 + 4 * j, "+---", 4);
+    memcpy(border + 4 + 4 * size, "+\n", 2);
+    size_t borderLength = 6 + 4 * (size_t)size;
+
+    putText(frame, "    ");
+    for (int j = 0; j < size; j++) {
+        line[0] = line[3] = ' ';
+        number2(line + 1, j + 1);
+        put(frame, line, 4);
+    }
+    putText(frame, "\n");
+    put(frame, border, borderLength);
+
+    for (int i = 0; i < size; i++) {
+        line[0] = line[3] = ' ';
+        number2(line + 1, i + 1);
+        for (int j = 0; j < size; j++) {
+            memcpy(line + 4 + 4 * j, "|   ", 4);
+            line[6 + 4 * j] = boardCell(board, i, j);
+        }
+        memcpy(line + 4 + 4 * size, "|\n", 2);
+        put(frame, line, 6 + 4 * (size_t)size);
+        put(frame, border, borderLength);
+    }
+    putText(frame, "\n");
+}
+
+// The compact grid: numbers and symbols two characters apart
+static void putCompact(Frame *frame, const Board *board) {
+    int size = board->size;
+    char line[8 + 2 * BOARD_MAX_SIZE];
+
+    memcpy(line, "  ", 2);
+    for (int j = 0; j < size; j++) number2(line + 2 + 2 * j, j + 1);
+    line[2 + 2 * size] = '\n';
+    put(frame, line, 3 + 2 * (size_t)size);
+
+    for (int i = 0; i < size; i++) {
+        number2(line, i + 1);
+        for (int j = 0; j < size; j++) {
+            line[2 + 2 * j] = ' ';
+            line[3 + 2 * j] = boardCell(board, i, j);
+        }
+        line[2 + 2 * size] = '\n';
+        put(frame, line, 3 + 2 * (size_t)size);
+    }
+    putText(frame, "\n");
+}
+
+static void putFullFrame(Frame *frame, const Renderer *renderer, const Board *board) {
+    if (renderer->header != NULL) putText(frame, renderer->header);
+    putBoxed(frame, board);
+}
+
+void renderPrint(const Board *board, RenderStyle style) {
+    Frame frame;
+    frame.length = 0;
+    if (style == RENDER_COMPACT) {
+        putCompact(&frame, board);
+    } else {
+        putBoxed(&frame, board);
+    }
+    flushFrame(&frame);
+}
+
+// First row or column of a window of span cells around center, kept on a bounded board
+static int viewStart(const BigBoard *board, int center, int span) {
+    int start = center - span / 2;
+    if (board->size != BIG_UNBOUNDED) {
+        if (start > board->size - span) start = board->size - span;
+        if (start < 0) start = 0;
+    }
+    return start;
+}
+
+void renderViewport(const BigBoard *board, int rows, int cols) {
+    int shown = (board->size == BIG_UNBOUNDED) ? 0 : 1;  // Added to shown coordinates
+    if (board->size != BIG_UNBOUNDED) {
+        if (rows > board->size) rows = board->size;
+        if (cols > board->size) cols = board->size;
+    }
+    if (cols > 4 * RENDER_VIEWPORT) cols = 4 * RENDER_VIEWPORT;
+
+    int centerRow = 0, centerCol = 0;
+    if (board->moveCount > 0) {
+        centerRow = board->lastRow;
+        centerCol = board->lastCol;
+    } else if (board->size != BIG_UNBOUNDED) {
+        centerRow = centerCol = board->size / 2;
+    }
+    int top = viewStart(board, centerRow, rows), left = viewStart(board, centerCol, cols);
+
+    Frame frame;
+    char line[32 + 8 * RENDER_VIEWPORT];
+    char number[16];
+    frame.length = 0;
+
+    int length = snprintf(line, sizeof(line), "Rows %d to %d, columns %d to %d", top + shown, top + rows - 1 + shown,
+                          left + shown, left + cols - 1 + shown);
+    put(&frame, line, (size_t)length);
+    if (board->size == BIG_UNBOUNDED) {
+        putText(&frame, " (unbounded board)\n");
+    } else {
+        length = snprintf(line, sizeof(line), " of %d x %d\n", board->size, board->size);
+        put(&frame, line, (size_t)length);
+    }
+
+    // Row numbers take the width of the widest one in the window
+    int width = snprintf(number, sizeof(number), "%d", top + shown);
+    int lastWidth = snprintf(number, sizeof(number), "%d", top + rows - 1 + shown);
+    if (lastWidth > width) width = lastWidth;
+
+    // Column ruler: numbers of the columns divisible by 5, where they fit
+    int lineLength = width + 2 * cols;
+    int nextFree = 0;
+    memset(line, ' ', (size_t)lineLength);
+    for (int j = 0; j < cols; j++) {
+        int column = left + j + shown;
+        if (column % 5 != 0) continue;
+        int at = width + 1 + 2 * j;
+        int digits = snprintf(number, sizeof(number), "%d", column);
+        if (at < nextFree || at + digits > lineLength) continue;
+        memcpy(line + at, number, (size_t)digits);
+        nextFree = at + digits + 1;
+    }
+    line[lineLength] = '\n';
+    put(&frame, line, (size_t)lineLength + 1);
+
+    for (int i = 0; i < rows; i++) {
+        int digits = snprintf(number, sizeof(number), "%d", top + i + shown);
+        memset(line, ' ', (size_t)width);
+        memcpy(line + width - digits, number, (size_t)digits);
+        for (int j = 0; j < cols; j++) {
+            char symbol = bigCell(board, top + i, left + j);
+            line[width + 2 * j] = ' ';
+            line[width + 1 + 2 * j] = (symbol == EMPTY_CELL) ? '.' : symbol;
+        }
+        line[lineLength] = '\n';
+        put(&frame, line, (size_t)lineLength + 1);
+    }
+    putText(&frame, "\n");
+    flushFrame(&frame);
+}
+
+void renderBoard(Renderer *renderer, const Board *board) {
+    int size = board->size;
+    int frameLines = cellLine(renderer, size) + 1;  // First line after the board and its blank line
+    Frame frame;
+    frame.length = 0;
+
+    if (!renderer->ansi) {
+        putFullFrame(&frame, renderer, board);
+        flushFrame(&frame);
+        return;
+    }
+
+    // Patching needs the board to stay where it was drawn, so the screen
+    // must not scroll - redraw in full when there is no room for prompts
+    int rows = terminalRows();
+    int patch = renderer->onScreen && renderer->size == size && (rows == 0 || rows >= frameLines + PROMPT_LINES);
+
+    if (!patch) {
+        putText(&frame, "\x1b[H\x1b[2J");
+        putFullFrame(&frame, renderer, board);
+    } else {
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                char symbol = boardCell(board, i, j);
+                if (symbol == renderer->shown[i * size + j]) continue;
+                putCursor(&frame, cellLine(renderer, i), cellColumn(j));
+                put(&frame, &symbol, 1);
+            }
+        }
+        putCursor(&frame, frameLines, 1);
+        putText(&frame, "\x1b[J");  // Clear the old prompts below the board
+    }
+
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) renderer->shown[i * size + j] = boardCell(board, i, j);
+    }
+    renderer->size = size;
+    renderer->onScreen = 1;
+    flushFrame(&frame);
+}
@@ -0,0 +1,52 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "board.h"
+#include "bigboard.h"
+
+// Terminal board renderer. Each frame is built in one buffer and written with
+// a single write() - no clear-screen process, no printf per cell. On a
+// terminal that understands ANSI escapes only the cells that changed since
+// the last frame are redrawn (cursor positioning), and the prompt area below
+// the board is cleared; when stdout is a file or pipe the whole board is
+// written as plain text every time. Part of the game core (gamecore.h).
+
+typedef struct {
+    const char *header;             // Text shown above the board (each line ending in '\n'), or NULL
+    int headerLines;
+    int ansi;                       // 1 = stdout is a terminal with ANSI cursor control
+    int onScreen;                   // 1 = a full frame is on screen and can be patched
+    int size;                       // Board size of that frame
+    char shown[BOARD_MAX_CELLS];    // Symbol on screen in each cell
+} Renderer;
+
+// Board layouts used by the front ends
+typedef enum {
+    RENDER_BOXED,    // "+---+" borders around every cell (the Renderer's layout)
+    RENDER_COMPACT   // Row and column numbers with the symbols two characters apart
+} RenderStyle;
+
+// Set up for stdout; header is kept by pointer, not copied
+void renderInit(Renderer *renderer, const char *header);
+
+// Clear the screen (ANSI only) and forget what is on it
+void renderClear(Renderer *renderer);
+
+// Show board: the first frame (or after a size change, renderClear or when
+// the terminal is too short to patch safely) is drawn in full, later frames
+// only rewrite changed cells. The cursor ends on the line below the board.
+void renderBoard(Renderer *renderer, const Board *board);
+
+// Write board once in full as plain text, in one write() - for front ends
+// that scroll instead of redrawing in place
+void renderPrint(const Board *board, RenderStyle style);
+
+#define RENDER_VIEWPORT 15  // Rows and columns of a large board shown at once
+
+// Write the rows x cols window of a large board around its last move (kept
+// inside a bounded board) in one write(): row numbers on the left, every
+// fifth column numbered above, empty cells as '.'. Coordinates are shown
+// 1-based on a bounded board and as stored on an unbounded one.
+void renderViewport(const BigBoard *board, int rows, int cols);
+
+#endif
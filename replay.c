@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "archive.h"
+#include "ai.h"
+#include "timer.h"
+
+// Replays saved games (text results or binary record files) on the bitboard:
+// shows any game at any move, or re-checks every game in an archive against
+// the current rules - each move must be legal, only the last move may win and
+// the stored winner must match. Uses the archive's .idx file, so jumping to
+// game K and splitting --verify between threads cost no extra pass.
+
+#define REPLAY_MAX_THREADS 64
+#define REPLAY_SHOW_FAILURES 10  // Failing games listed by --verify
+
+static void printUsage(const char *program) {
+    printf("Usage: %s FILE                        Count the games in FILE\n", program);
+    printf("       %s FILE --game N [--move K]    Show game N (from 1), the board after move K\n", program);
+    printf("       %s FILE --verify [--threads N] Re-check every game against the rules\n", program);
+}
+
+static void printBoard(const Board *board) {
+    for (int row = 0; row < board->size; row++) {
+        printf("  ");
+        for (int col = 0; col < board->size; col++) {
+            printf(" %c", boardCell(board, row, col));
+        }
+        printf("\n");
+    }
+}
+
+static int showGame(const Archive *archive, long long game, int move) {
+    GameRecord record;
+    if (!archiveGame(archive, game - 1, &record)) {
+        printf("Game %lld is %s.\n", game, game < 1 || game > archive->count ? "not in the file" : "malformed");
+        return 1;
+    }
+    if (move < 0 || move > record.moveCount) move = record.moveCount;
+
+    printf("Game %lld: %d x %d", game, record.size, record.size);
+    if (record.winLength < record.size) printf(" (%d in a row)", record.winLength);
+    printf(", mode %d, %d players, %d moves", record.mode, record.players, record.moveCount);
+    if (record.seed != 0) printf(", seed %u game %u", record.seed, record.number);
+    printf("\n");
+    for (int i = 0; i < move; i++) {
+        printf("  Move %d: %c at (%d, %d)\n", i + 1, playerToSymbol(i % record.players),
+               record.moves[i] / record.size + 1, record.moves[i] % record.size + 1);
+    }
+
+    Board board;
+    int played = recordReplay(&record, move, &board);
+    printf("\nAfter move %d:\n", played);
+    printBoard(&board);
+    if (played < move) printf("Move %d is illegal.\n", played + 1);
+
+    int bad;
+    ReplayStatus status = recordCheck(&record, &bad);
+    if (status == REPLAY_OK) {
+        if (record.winner >= 0) {
+            printf("Result: %c wins\n", playerToSymbol(record.winner));
+        } else {
+            printf("Result: draw\n");
+        }
+    } else {
+        printf("Check failed at move %d: %s\n", bad + 1, replayStatusName(status));
+    }
+    return status != REPLAY_OK;
+}
+
+typedef struct {
+    const Archive *archive;
+    long long begin, end;           // Games [begin, end)
+    long long checked;
+    long long failed;
+    long long malformed;
+    long long firstFailed[REPLAY_SHOW_FAILURES];
+    ReplayStatus firstStatus[REPLAY_SHOW_FAILURES];
+} VerifyJob;
+
+static void *verifyThread(void *arg) {
+    VerifyJob *job = (VerifyJob *)arg;
+    GameRecord record;
+
+    for (long long k = job->begin; k < job->end; k++) {
+        if (!archiveGame(job->archive, k, &record)) {
+            job->malformed++;
+            continue;
+        }
+        ReplayStatus status = recordCheck(&record, NULL);
+        if (status != REPLAY_OK) {
+            if (job->failed < REPLAY_SHOW_FAILURES) {
+                job->firstFailed[job->failed] = k;
+                job->firstStatus[job->failed] = status;
+            }
+            job->failed++;
+        }
+        job->checked++;
+    }
+    return NULL;
+}
+
+static int verifyArchive(const Archive *archive, int threads) {
+    if (threads > REPLAY_MAX_THREADS) threads = REPLAY_MAX_THREADS;
+    if (threads < 1 || archive->count < 10000) threads = 1;
+
+    VerifyJob jobs[REPLAY_MAX_THREADS];
+    pthread_t ids[REPLAY_MAX_THREADS];
+    int started[REPLAY_MAX_THREADS] = {0};
+    memset(jobs, 0, sizeof(jobs));
+
+    double start = nowSeconds();
+    for (int t = 0; t < threads; t++) {
+        jobs[t].archive = archive;
+        jobs[t].begin = archive->count * t / threads;
+        jobs[t].end = archive->count * (t + 1) / threads;
+        if (t > 0) started[t] = pthread_create(&ids[t], NULL, verifyThread, &jobs[t]) == 0;
+    }
+    verifyThread(&jobs[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(ids[t], NULL);
+        } else {
+            verifyThread(&jobs[t]);
+        }
+    }
+    double seconds = nowSeconds() - start;
+
+    long long checked = 0, failed = 0, malformed = 0;
+    int shown = 0;
+    for (int t = 0; t < threads; t++) {
+        for (long long i = 0; i < jobs[t].failed && i < REPLAY_SHOW_FAILURES && shown < REPLAY_SHOW_FAILURES; i++) {
+            printf("Game %lld: %s\n", jobs[t].firstFailed[i] + 1, replayStatusName(jobs[t].firstStatus[i]));
+            shown++;
+        }
+        checked += jobs[t].checked;
+        failed += jobs[t].failed;
+        malformed += jobs[t].malformed;
+    }
+    printf("Checked %lld games: %lld ok, %lld failed, %lld malformed\n", checked, checked - failed, failed, malformed);
+    printf("%.3f s, %.0f games/s (%d threads)\n", seconds, seconds > 0 ? (double)checked / seconds : 0.0, threads);
+    return failed > 0 || malformed > 0;
+}
+
+int main(int argc, char *argv[]) {
+    long long game = 0;
+    int move = -1;
+    int verify = 0;
+    int threads = aiDefaultThreads();
+
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--game") == 0 && i + 1 < argc) {
+            game = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--move") == 0 && i + 1 < argc) {
+            move = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Archive archive;
+    if (!archiveOpen(&archive, argv[1], 1)) {
+        fprintf(stderr, "Cannot read %s.\n", argv[1]);
+        return 1;
+    }
+
+    int status = 0;
+    if (verify) {
+        status = verifyArchive(&archive, threads);
+    } else if (game != 0) {
+        status = showGame(&archive, game, move);
+    } else {
+        printf("%s: %s file, %lld games, %.1f MB\n", argv[1], archive.format == ARCHIVE_BINARY ? "binary" : "text",
+               archive.count, (double)archive.size / 1e6);
+    }
+    archiveClose(&archive);
+    return status;
+}
@@ -0,0 +1,59 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Small, fast, seedable random number generator (xoshiro256**).
+// Each thread or agent owns its own Rng, so there is no shared state like rand().
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+// splitmix64 step: turns any 64-bit value into a well-mixed one
+static inline uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline void rngSeed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix64(&seed);
+}
+
+// Seed for stream number index of a run started with seed: streams for
+// different indices are independent, so work can be split any way
+static inline uint64_t rngStreamSeed(uint64_t seed, uint64_t index) {
+    uint64_t x = seed ^ (index * 0xD1B54A32D192ED03ull);
+    return splitmix64(&x);
+}
+
+static inline uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = ((s[1] * 5) << 7 | (s[1] * 5) >> 57) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+// Uniform value in [0, n) without modulo bias (Lemire's multiply-shift method)
+static inline uint32_t rngBelow(Rng *rng, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = (uint32_t)(-n) % n;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+#endif
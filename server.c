@@ -0,0 +1,398 @@
+#define _GNU_SOURCE  // accept4
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "session.h"
+#include "timer.h"
+
+// Hosts many games at once for remote front ends: clients connect to a Unix
+// socket and speak the line protocol of session.h, any number of games per
+// connection. One thread runs a level-triggered epoll loop over every
+// connection and never searches: the session's worker threads find the
+// computer moves and wake the loop through the session's notify pipe, so a
+// long search holds up only its own game. Clients, their buffers and the
+// games are all allocated at start-up, so a busy server does no allocation. A client that stops
+// reading its replies is not served further until it does (its commands wait
+// in its input buffer) - one slow client never holds up the rest. --stdio
+// serves a single client on standard input and output instead, for scripts
+// and testing. Linux only (epoll).
+
+#define SERVER_DEFAULT_SOCKET "tictactoe.sock"
+#define SERVER_DEFAULT_GAMES 4096
+#define SERVER_DEFAULT_CLIENTS 1024
+#define SERVER_DEFAULT_DEPTH 4       // Search depth of the computer seats
+#define SERVER_MCTS_PLAYOUTS 2000    // Playouts per move with --engine mcts
+#define SERVER_EVENTS 256            // Events taken per epoll_wait
+#define CLIENT_IN_BUFFER 4096
+#define CLIENT_OUT_BUFFER (4 * SESSION_REPLY_MAX)  // Up to 3 games thinking while commands still run
+
+typedef struct {
+    int fd;                         // -1 = free
+    unsigned int events;            // Events epoll watches for this client
+    size_t inLength;
+    size_t outStart, outLength;     // Unsent replies: out[outStart, outStart + outLength)
+    int skipping;                   // Dropping the rest of an overlong line
+    char in[CLIENT_IN_BUFFER];
+    char out[CLIENT_OUT_BUFFER];
+} Client;
+
+typedef struct {
+    Session *session;
+    Client *clients;
+    int maxClients;
+    int connected;
+    int epoll;
+    int listener;
+} Server;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int signal) {
+    (void)signal;
+    stopRequested = 1;
+}
+
+static void printUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --socket PATH       Unix socket to listen on (default: %s)\n", SERVER_DEFAULT_SOCKET);
+    printf("  --stdio             Serve one client on standard input and output instead\n");
+    printf("  --games N           Games open at once, across all clients (default: %d)\n", SERVER_DEFAULT_GAMES);
+    printf("  --clients N         Connections at once (default: %d)\n", SERVER_DEFAULT_CLIENTS);
+    printf("  --workers N         Threads searching computer moves (default: one per core)\n");
+    printf("  --engine NAME       Computer seats: minimax, mcts or random (default: minimax)\n");
+    printf("  --depth D           Minimax search depth (default: %d)\n", SERVER_DEFAULT_DEPTH);
+    printf("  --book FILE         Book file for the computer seats (default: %s, none = no book)\n",
+           BOOK_DEFAULT_PATH);
+    printf("  --log FILE          Log every finished game to FILE\n");
+    printf("  --log-format FMT    text, csv or binary (default: text)\n");
+}
+
+static void setInterest(Server *server, Client *client) {
+    unsigned int events = 0;
+    if (client->inLength < CLIENT_IN_BUFFER) events |= EPOLLIN;
+    if (client->outLength > 0) events |= EPOLLOUT;
+    if (events == client->events) return;
+
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = client;
+    epoll_ctl(server->epoll, EPOLL_CTL_MOD, client->fd, &event);
+    client->events = events;
+}
+
+static void closeClient(Server *server, Client *client) {
+    epoll_ctl(server->epoll, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    sessionDropOwner(server->session, (int)(client - server->clients));
+    client->fd = -1;
+    server->connected--;
+}
+
+// Run every complete line in the input buffer while the replies still fit.
+// Room stays reserved for the computer moves still to come in the client's
+// games (SESSION_REPLY_MAX each), so deliverResults always has space.
+static void runCommands(Server *server, Client *client) {
+    int owner = (int)(client - server->clients);
+    size_t start = 0;
+
+    if (client->outStart > 0) {
+        memmove(client->out, client->out + client->outStart, client->outLength);
+        client->outStart = 0;
+    }
+    while (client->outLength + (size_t)(sessionPending(server->session, owner) + 1) * SESSION_REPLY_MAX <=
+           CLIENT_OUT_BUFFER) {
+        char *line = client->in + start;
+        char *end = (char *)memchr(line, '\n', client->inLength - start);
+        if (end == NULL) break;
+        start = (size_t)(end - client->in) + 1;
+        if (client->skipping) {
+            client->skipping = 0;
+            continue;
+        }
+        if (end > line && end[-1] == '\r') end--;
+        *end = '\0';
+        char *out = client->out + client->outLength;
+        if (end - line >= SESSION_LINE_MAX) {
+            client->outLength += (size_t)sprintf(out, "ERR line too long\n");
+        } else {
+            client->outLength += sessionCommand(server->session, owner, line, out);
+        }
+    }
+
+    client->inLength -= start;
+    memmove(client->in, client->in + start, client->inLength);
+    if (client->inLength == CLIENT_IN_BUFFER && memchr(client->in, '\n', client->inLength) == NULL) {
+        // A full buffer without a newline: answer now, drop the line as it arrives
+        client->inLength = 0;
+        if (!client->skipping && client->outLength + SESSION_REPLY_MAX <= CLIENT_OUT_BUFFER) {
+            client->outLength += (size_t)sprintf(client->out + client->outLength, "ERR line too long\n");
+        }
+        client->skipping = 1;
+    }
+}
+
+// Send what the socket takes; returns 0 if the connection failed
+static int sendReplies(Client *client) {
+    while (client->outLength > 0) {
+        ssize_t n = send(client->fd, client->out + client->outStart, client->outLength, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        client->outStart += (size_t)n;
+        client->outLength -= (size_t)n;
+    }
+    client->outStart = 0;
+    return 1;
+}
+
+static void serveClient(Server *server, Client *client, unsigned int events) {
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        ssize_t n = 0;
+        if (client->inLength < CLIENT_IN_BUFFER) {
+            n = recv(client->fd, client->in + client->inLength, CLIENT_IN_BUFFER - client->inLength, 0);
+        }
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            closeClient(server, client);
+            return;
+        }
+        if (n > 0) client->inLength += (size_t)n;
+    }
+    runCommands(server, client);
+    if (!sendReplies(client)) {
+        closeClient(server, client);
+        return;
+    }
+    // Sending made room for replies to commands still waiting
+    if (client->inLength > 0 && client->outLength == 0) {
+        runCommands(server, client);
+        if (!sendReplies(client)) {
+            closeClient(server, client);
+            return;
+        }
+    }
+    setInterest(server, client);
+}
+
+// Hand the computer moves the workers found to their clients, then serve
+// those clients (a finished search may let waiting commands run)
+static void deliverResults(Server *server) {
+    char out[SESSION_REPLY_MAX];
+    for (;;) {
+        int owner;
+        size_t length = sessionResult(server->session, &owner, out);
+        if (owner < 0) break;
+        Client *client = &server->clients[owner];
+        if (client->fd < 0) continue;
+        if (client->outStart + client->outLength + length > CLIENT_OUT_BUFFER) {
+            memmove(client->out, client->out + client->outStart, client->outLength);
+            client->outStart = 0;
+        }
+        memcpy(client->out + client->outStart + client->outLength, out, length);
+        client->outLength += length;
+        serveClient(server, client, 0);
+    }
+}
+
+static void acceptClients(Server *server) {
+    for (;;) {
+        int fd = accept4(server->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN: nothing more waiting
+        Client *client = NULL;
+        for (int i = 0; i < server->maxClients && client == NULL; i++) {
+            if (server->clients[i].fd < 0) client = &server->clients[i];
+        }
+        if (client == NULL) {
+            static const char full[] = "ERR server full\n";
+            send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL);
+            close(fd);
+            continue;
+        }
+        client->fd = fd;
+        client->events = EPOLLIN;
+        client->inLength = client->outStart = client->outLength = 0;
+        client->skipping = 0;
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = client;
+        if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            client->fd = -1;
+            continue;
+        }
+        server->connected++;
+    }
+}
+
+static int openListener(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    unlink(path);  // A socket left by an earlier run
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int serveSocket(Session *session, const char *path, int maxClients) {
+    Server server;
+    memset(&server, 0, sizeof(server));
+    server.session = session;
+    server.maxClients = maxClients;
+    server.clients = (Client *)malloc((size_t)maxClients * sizeof(Client));
+    server.listener = openListener(path);
+    server.epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (server.clients == NULL || server.listener < 0 || server.epoll < 0) {
+        fprintf(stderr, "Cannot listen on %s: %s\n", path, strerror(errno));
+        free(server.clients);
+        return 1;
+    }
+    for (int i = 0; i < maxClients; i++) server.clients[i].fd = -1;
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;  // The listener
+    epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.listener, &event);
+    event.data.ptr = session;  // Computer moves found
+    epoll_ctl(server.epoll, EPOLL_CTL_ADD, sessionNotifyFd(session), &event);
+    printf("Listening on %s (%d clients)\n", path, maxClients);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_EVENTS];
+    while (!stopRequested) {
+        int count = epoll_wait(server.epoll, events, SERVER_EVENTS, -1);
+        for (int i = 0; i < count; i++) {
+            Client *client = (Client *)events[i].data.ptr;
+            if (client == NULL) {
+                acceptClients(&server);
+            } else if (events[i].data.ptr == session) {
+                deliverResults(&server);
+            } else if (client->fd >= 0) {
+                serveClient(&server, client, events[i].events);
+            }
+        }
+    }
+
+    for (int i = 0; i < maxClients; i++) {
+        if (server.clients[i].fd >= 0) closeClient(&server, &server.clients[i]);
+    }
+    close(server.listener);
+    close(server.epoll);
+    unlink(path);
+    free(server.clients);
+    return 0;
+}
+
+static int serveStdio(Session *session) {
+    char line[CLIENT_IN_BUFFER];
+    char out[SESSION_REPLY_MAX];
+    while (!stopRequested && fgets(line, sizeof(line), stdin) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        size_t length = (strlen(line) >= SESSION_LINE_MAX) ? (size_t)sprintf(out, "ERR line too long\n")
+                                                            : sessionCommand(session, 0, line, out);
+        fwrite(out, 1, length, stdout);
+        // One command at a time: wait for its computer moves
+        while (sessionPending(session, 0) > 0) {
+            sessionWait(session);
+            int owner;
+            while ((length = sessionResult(session, &owner, out)) > 0 || owner >= 0) fwrite(out, 1, length, stdout);
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *socketPath = SERVER_DEFAULT_SOCKET;
+    const char *logPath = NULL;
+    int useStdio = 0;
+    int maxGames = SERVER_DEFAULT_GAMES;
+    int maxClients = SERVER_DEFAULT_CLIENTS;
+    int workers = aiDefaultThreads();
+    GameLogSettings logSettings;
+    gameLogDefaults(&logSettings);
+    logSettings.flush = LOG_FLUSH_FULL;  // Finished games come too fast to write one by one
+
+    // Each worker has a single-threaded player: a fixed depth keeps every
+    // search short, however many games are waiting
+    ComputerSettings computer;
+    computerDefaults(&computer);
+    computer.threads = 1;
+    computer.timeLimit = 0;
+    computer.maxDepth = SERVER_DEFAULT_DEPTH;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--stdio") == 0) {
+            useStdio = 1;
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            maxGames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            maxClients = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc && parseEngine(argv[i + 1], &computer.engine)) {
+            i++;
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            computer.maxDepth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+            i++;
+            computer.bookPath = (strcmp(argv[i], "none") == 0) ? NULL : argv[i];
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (strcmp(argv[i], "--log-format") == 0 && i + 1 < argc && parseLogFormat(argv[i + 1], &logSettings.format)) {
+            i++;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (maxGames < 1 || maxClients < 1 || workers < 1 || workers > AI_MAX_THREADS || computer.maxDepth < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (computer.engine == ENGINE_MCTS) computer.playouts = SERVER_MCTS_PLAYOUTS;
+
+    GameLog *log = NULL;
+    if (logPath != NULL && (log = gameLogOpen(logPath, 1, &logSettings)) == NULL) {
+        fprintf(stderr, "Cannot open %s.\n", logPath);
+        return 1;
+    }
+    Session *session = sessionCreate(maxGames, useStdio ? 1 : maxClients, workers, &computer, log);
+    if (session == NULL) {
+        fprintf(stderr, "Out of memory for %d games and %d workers.\n", maxGames, workers);
+        gameLogClose(log);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;  // No SA_RESTART: epoll_wait returns and the loop ends
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    double start = nowSeconds();
+    int status = useStdio ? serveStdio(session) : serveSocket(session, socketPath, maxClients);
+    if (!useStdio) {
+        char stats[SESSION_REPLY_MAX];
+        sessionCommand(session, -1, "STATS", stats);
+        printf("%s after %.1f s\n", strtok(stats, "\n"), nowSeconds() - start);
+    }
+    sessionDestroy(session);
+    gameLogClose(log);
+    return status;
+}
@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include "session.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+    long long id;              // 0 = free slot
+    long long uses;            // Games this slot has held - keeps ids unique
+    int owner;                 // Client that started the game
+    int mode, players;
+    int nextFree;              // Free list link
+    int thinking;              // A worker is searching this game's computer move
+    Board board;
+    char names[BOARD_MAX_PLAYERS][GAME_NAME_MAX];
+    int isComputer[BOARD_MAX_PLAYERS];
+    unsigned char moves[BOARD_MAX_CELLS];  // For the log
+} SessionGame;
+
+// A computer move found by a worker, waiting for sessionResult
+typedef struct {
+    int slot;
+    int row, col;
+} SessionResult;
+
+typedef struct {
+    Session *session;
+    ComputerPlayer computer;   // Each worker searches with its own player
+    pthread_t thread;
+} SessionWorker;
+
+struct Session {
+    SessionGame *games;
+    int maxGames;
+    int freeHead;              // First free slot, -1 = pool full
+    int open;
+    long long played, moves;
+    int maxOwners;
+    int *pending;              // Games thinking per owner
+    GameLog *log;
+
+    SessionWorker *workers;
+    int workerCount;
+    atomic_int stop;           // Ends the searches under way at sessionDestroy
+    pthread_mutex_t lock;
+    pthread_cond_t jobReady;   // Signalled when a job is queued or the workers quit
+    pthread_cond_t resultReady;
+
+    // Under lock. Both queues are rings of maxGames entries: a game has at
+    // most one search queued, running or waiting to be taken, and its slot is
+    // not reused until that search is done (see closeGame)
+    int *jobs;                 // Slots of the games to search
+    int jobHead, jobCount;
+    SessionResult *results;
+    int resultHead, resultCount;
+    int quit;
+    int woken;                 // A byte is waiting in wake
+#ifndef _WIN32
+    int wake[2];               // Pipe written when results arrive, for the server's epoll
+#endif
+};
+
+#define OVERFLOW_LINE "ERR reply too long\n"
+
+// Reply being written into the caller's buffer
+typedef struct {
+    char *data;
+    size_t length;
+    int overflow;              // A line did not fit (cannot happen with SESSION_REPLY_MAX as sized)
+} Reply;
+
+// Append one line. Room for OVERFLOW_LINE is always kept back, and a line
+// that does not fit is dropped whole - never cut off part way.
+static void reply(Reply *r, const char *format, ...) {
+    size_t room = SESSION_REPLY_MAX - sizeof(OVERFLOW_LINE) - r->length;
+    if (r->overflow) return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(r->data + r->length, room, format, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= room) {
+        r->data[r->length] = '\0';
+        r->overflow = 1;
+        return;
+    }
+    r->length += (size_t)n;
+}
+
+static void *workerThread(void *arg) {
+    SessionWorker *worker = (SessionWorker *)arg;
+    Session *session = worker->session;
+    pthread_mutex_lock(&session->lock);
+    for (;;) {
+        while (session->jobCount == 0 && !session->quit) pthread_cond_wait(&session->jobReady, &session->lock);
+        if (session->quit) break;
+        int slot = session->jobs[session->jobHead];
+        session->jobHead = (session->jobHead + 1) % session->maxGames;
+        session->jobCount--;
+        pthread_mutex_unlock(&session->lock);
+
+        // Nothing writes to a thinking game's board until its result is taken
+        const SessionGame *game = &session->games[slot];
+        int row, col;
+        computerMove(&worker->computer, &game->board, game->board.moveCount % game->players, &row, &col);
+
+        pthread_mutex_lock(&session->lock);
+        SessionResult *result = &session->results[(session->resultHead + session->resultCount) % session->maxGames];
+        result->slot = slot;
+        result->row = row;
+        result->col = col;
+        session->resultCount++;
+        pthread_cond_signal(&session->resultReady);
+#ifndef _WIN32
+        char byte = 1;
+        if (!session->woken && write(session->wake[1], &byte, 1) == 1) session->woken = 1;
+#endif
+    }
+    pthread_mutex_unlock(&session->lock);
+    return NULL;
+}
+
+// Finish the reply: a line that did not fit is reported, never left out silently
+static size_t endReply(Reply *r) {
+    if (r->overflow) {
+        memcpy(r->data + r->length, OVERFLOW_LINE, sizeof(OVERFLOW_LINE));
+        r->length += sizeof(OVERFLOW_LINE) - 1;
+    }
+    return r->length;
+}
+
+Session *sessionCreate(int maxGames, int maxOwners, int workers, const ComputerSettings *computer, GameLog *log) {
+    Session *session = (Session *)calloc(1, sizeof(Session));
+    if (session == NULL) return NULL;
+    session->maxGames = maxGames;
+    session->maxOwners = maxOwners;
+    session->log = log;
+    atomic_init(&session->stop, 0);
+    pthread_mutex_init(&session->lock, NULL);
+    pthread_cond_init(&session->jobReady, NULL);
+    pthread_cond_init(&session->resultReady, NULL);
+
+    session->games = (SessionGame *)calloc((size_t)maxGames, sizeof(SessionGame));
+    session->pending = (int *)calloc((size_t)maxOwners, sizeof(int));
+    session->jobs = (int *)calloc((size_t)maxGames, sizeof(int));
+    session->results = (SessionResult *)calloc((size_t)maxGames, sizeof(SessionResult));
+    session->workers = (SessionWorker *)calloc((size_t)workers, sizeof(SessionWorker));
+    int ok = session->games != NULL && session->pending != NULL && session->jobs != NULL &&
+             session->results != NULL && session->workers != NULL;
+#ifndef _WIN32
+    session->wake[0] = session->wake[1] = -1;
+    if (ok && pipe(session->wake) != 0) {
+        session->wake[0] = session->wake[1] = -1;
+        ok = 0;
+    }
+    for (int i = 0; i < 2 && ok; i++) {
+        fcntl(session->wake[i], F_SETFL, fcntl(session->wake[i], F_GETFL) | O_NONBLOCK);
+        fcntl(session->wake[i], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    for (int i = 0; i < workers && ok; i++) {
+        SessionWorker *worker = &session->workers[i];
+        worker->session = session;
+        ok = computerInit(&worker->computer, computer);
+        if (!ok) break;
+        worker->computer.aiLimits.stop = &session->stop;
+        worker->computer.mctsLimits.stop = &session->stop;
+        if (pthread_create(&worker->thread, NULL, workerThread, worker) != 0) {
+            computerFree(&worker->computer);
+            ok = 0;
+            break;
+        }
+        session->workerCount++;
+    }
+    if (!ok) {
+        sessionDestroy(session);
+        return NULL;
+    }
+
+    for (int i = 0; i < maxGames; i++) session->games[i].nextFree = (i + 1 < maxGames) ? i + 1 : -1;
+    session->freeHead = 0;
+    return session;
+}
+
+void sessionDestroy(Session *session) {
+    if (session == NULL) return;
+    pthread_mutex_lock(&session->lock);
+    session->quit = 1;
+    atomic_store(&session->stop, 1);
+    pthread_cond_broadcast(&session->jobReady);
+    pthread_mutex_unlock(&session->lock);
+    for (int i = 0; i < session->workerCount; i++) {
+        pthread_join(session->workers[i].thread, NULL);
+        computerFree(&session->workers[i].computer);
+    }
+#ifndef _WIN32
+    for (int i = 0; i < 2; i++) {
+        if (session->wake[i] >= 0) close(session->wake[i]);
+    }
+#endif
+    pthread_cond_destroy(&session->resultReady);
+    pthread_cond_destroy(&session->jobReady);
+    pthread_mutex_destroy(&session->lock);
+    free(session->workers);
+    free(session->results);
+    free(session->jobs);
+    free(session->pending);
+    free(session->games);
+    free(session);
+}
+
+int sessionOpenGames(const Session *session) {
+    return session->open;
+}
+
+int sessionPending(const Session *session, int owner) {
+    return (owner >= 0 && owner < session->maxOwners) ? session->pending[owner] : 0;
+}
+
+int sessionNotifyFd(const Session *session) {
+#ifndef _WIN32
+    return session->wake[0];
+#else
+    (void)session;
+    return -1;
+#endif
+}
+
+void sessionWait(Session *session) {
+    pthread_mutex_lock(&session->lock);
+    while (session->resultCount == 0) pthread_cond_wait(&session->resultReady, &session->lock);
+    pthread_mutex_unlock(&session->lock);
+}
+
+static void freeSlot(Session *session, SessionGame *game) {
+    game->nextFree = session->freeHead;
+    session->freeHead = (int)(game - session->games);
+}
+
+static void stopThinking(Session *session, SessionGame *game) {
+    game->thinking = 0;
+    session->pending[game->owner]--;
+}
+
+// A game closed while a worker searches for it keeps its slot (with id 0,
+// so no command finds it) until sessionResult takes the search back
+static void closeGame(Session *session, SessionGame *game) {
+    game->id = 0;
+    session->open--;
+    if (!game->thinking) freeSlot(session, game);
+}
+
+static SessionGame *findGame(Session *session, int owner, long long id) {
+    if (id <= 0) return NULL;
+    SessionGame *game = &session->games[(id - 1) % session->maxGames];
+    return (game->id == id && game->owner == owner) ? game : NULL;
+}
+
+static void place(Session *session, SessionGame *game, Reply *r, int row, int col) {
+    int player = game->board.moveCount % game->players;
+    game->moves[game->board.moveCount] = (unsigned char)(row * game->board.size + col);
+    boardPlace(&game->board, row, col, player);
+    session->moves++;
+    reply(r, "MOVED %lld %c %d %d\n", game->id, playerToSymbol(player), row + 1, col + 1);
+}
+
+static int isOver(const SessionGame *game) {
+    return game->board.winner >= 0 || boardIsDraw(&game->board);
+}
+
+// If a computer seat is to move, queue its search for the workers and
+// return 1: the game then waits for sessionResult to play the move
+static int startComputer(Session *session, SessionGame *game) {
+    if (isOver(game) || !game->isComputer[game->board.moveCount % game->players]) return 0;
+    if (!game->thinking) {
+        game->thinking = 1;
+        session->pending[game->owner]++;
+    }
+    pthread_mutex_lock(&session->lock);
+    session->jobs[(session->jobHead + session->jobCount) % session->maxGames] = (int)(game - session->games);
+    session->jobCount++;
+    pthread_cond_signal(&session->jobReady);
+    pthread_mutex_unlock(&session->lock);
+    return 1;
+}
+
+// The state line; a finished game is logged and closed
+static void finishTurn(Session *session, SessionGame *game, Reply *r) {
+    const Board *board = &game->board;
+    if (!isOver(game)) {
+        reply(r, "TURN %lld %c\n", game->id, playerToSymbol(board->moveCount % game->players));
+        return;
+    }
+    if (board->winner >= 0) {
+        reply(r, "WIN %lld %c %s\n", game->id, playerToSymbol(board->winner), game->names[board->winner]);
+    } else {
+        reply(r, "DRAW %lld\n", game->id);
+    }
+
+    if (session->log != NULL) {
+        GameRecord record;
+        memset(&record, 0, sizeof(record));
+        record.size = board->size;
+        record.winLength = board->winLength;
+        record.mode = game->mode;
+        record.players = game->players;
+        for (int i = 0; i < game->players; i++) record.names[i] = game->names[i];
+        record.number = (unsigned int)session->played;
+        record.moveCount = board->moveCount;
+        memcpy(record.moves, game->moves, (size_t)board->moveCount);
+        record.winner = board->winner;
+        gameLogGame(session->log, &record);
+    }
+    session->played++;
+    closeGame(session, game);
+}
+
+static void newGame(Session *session, int owner, const char *line, Reply *r) {
+    int size = 0, mode = 0, winLength = 0;
+    char list[SESSION_LINE_MAX];
+    if (sscanf(line, "NEW %d %d %255s %d", &size, &mode, list, &winLength) < 3) {
+        reply(r, "ERR usage: NEW SIZE MODE NAMES [WIN]\n");
+        return;
+    }
+    if (size < BOARD_MIN_SIZE || size > BOARD_MAX_SIZE || mode < 1 || mode > 3) {
+        reply(r, "ERR size must be %d to %d and mode 1 to 3\n", BOARD_MIN_SIZE, BOARD_MAX_SIZE);
+        return;
+    }
+    if (winLength == 0) winLength = size;
+    if (winLength < BOARD_MIN_SIZE || winLength > size) {
+        reply(r, "ERR win length must be %d to the board size\n", BOARD_MIN_SIZE);
+        return;
+    }
+    if (session->freeHead < 0) {
+        reply(r, "ERR all %d games in use\n", session->maxGames);
+        return;
+    }
+
+    SessionGame *game = &session->games[session->freeHead];
+    int wanted = (mode == 3) ? 3 : (mode == 2) ? 1 : 2;  // The computer needs no name
+    if (gameParseNames(list, game->names) != wanted) {
+        reply(r, "ERR mode %d needs %d %s\n", mode, wanted, wanted == 1 ? "name" : "names");
+        return;
+    }
+    session->freeHead = game->nextFree;
+    session->open++;
+
+    // The slot is id - 1 mod maxGames; a stale id of an earlier game never matches
+    game->id = game->uses++ * session->maxGames + (game - session->games) + 1;
+    game->owner = owner;
+    game->mode = mode;
+    game->players = (mode == 3) ? 3 : 2;
+    if (mode == 2) strcpy(game->names[1], "Computer");
+    for (int i = 0; i < game->players; i++) {
+        game->isComputer[i] = (mode == 2 && i == 1) || (mode == 3 && strcmp(game->names[i], "Computer") == 0);
+    }
+    boardInitRule(&game->board, size, game->players, winLength);
+
+    reply(r, "GAME %lld %d %d\n", game->id, size, mode);
+    if (!startComputer(session, game)) finishTurn(session, game, r);
+}
+
+static void moveGame(Session *session, int owner, const char *line, Reply *r) {
+    long long id = 0;
+    int row = 0, col = 0;
+    if (sscanf(line, "MOVE %lld %d %d", &id, &row, &col) != 3) {
+        reply(r, "ERR usage: MOVE ID ROW COL\n");
+        return;
+    }
+    SessionGame *game = findGame(session, owner, id);
+    if (game == NULL) {
+        reply(r, "ERR no game %lld\n", id);
+        return;
+    }
+    if (game->thinking) {
+        reply(r, "ERR game %lld is waiting for the computer\n", id);
+        return;
+    }
+    if (!boardIsValidMove(&game->board, row - 1, col - 1)) {
+        reply(r, "ERR bad move %d %d\n", row, col);
+        return;
+    }
+    place(session, game, r, row - 1, col - 1);
+    if (!startComputer(session, game)) finishTurn(session, game, r);
+}
+
+static void showGame(Session *session, int owner, const char *line, Reply *r) {
+    long long id = 0;
+    SessionGame *game = (sscanf(line, "SHOW %lld", &id) == 1) ? findGame(session, owner, id) : NULL;
+    if (game == NULL) {
+        reply(r, "ERR no game %lld\n", id);
+        return;
+    }
+    char cells[BOARD_MAX_CELLS + 1];
+    for (int cell = 0; cell < game->board.cells; cell++) {
+        char symbol = boardCell(&game->board, cell / game->board.size, cell % game->board.size);
+        cells[cell] = (symbol == EMPTY_CELL) ? '.' : symbol;
+    }
+    cells[game->board.cells] = '\0';
+    reply(r, "BOARD %lld %d %s\n", id, game->board.size, cells);
+    finishTurn(session, game, r);
+}
+
+size_t sessionCommand(Session *session, int owner, const char *line, char *out) {
+    Reply r = { out, 0, 0 };
+    out[0] = '\0';
+
+    if (strncmp(line, "NEW ", 4) == 0) {
+        newGame(session, owner, line, &r);
+    } else if (strncmp(line, "MOVE ", 5) == 0) {
+        moveGame(session, owner, line, &r);
+    } else if (strncmp(line, "SHOW ", 5) == 0) {
+        showGame(session, owner, line, &r);
+    } else if (strncmp(line, "QUIT ", 5) == 0) {
+        long long id = atoll(line + 5);
+        SessionGame *game = findGame(session, owner, id);
+        if (game == NULL) {
+            reply(&r, "ERR no game %lld\n", id);
+        } else {
+            closeGame(session, game);
+            reply(&r, "CLOSED %lld\n", id);
+        }
+    } else if (strcmp(line, "STATS") == 0) {
+        reply(&r, "STATS %d %lld %lld\n", session->open, session->played, session->moves);
+    } else if (line[0] != '\0') {
+        reply(&r, "ERR unknown command\n");
+    }
+    return endReply(&r);
+}
+
+size_t sessionResult(Session *session, int *owner, char *out) {
+    Reply r = { out, 0, 0 };
+    out[0] = '\0';
+    *owner = -1;
+
+    pthread_mutex_lock(&session->lock);
+    if (session->resultCount == 0) {
+        // All taken: the next result writes a new wake-up byte
+#ifndef _WIN32
+        char byte;
+        while (read(session->wake[0], &byte, 1) == 1) {}
+#endif
+        session->woken = 0;
+        pthread_mutex_unlock(&session->lock);
+        return 0;
+    }
+    SessionResult result = session->results[session->resultHead];
+    session->resultHead = (session->resultHead + 1) % session->maxGames;
+    session->resultCount--;
+    pthread_mutex_unlock(&session->lock);
+
+    SessionGame *game = &session->games[result.slot];
+    *owner = game->owner;
+    if (game->id == 0) {
+        // Closed while the computer was thinking: the slot is free at last
+        stopThinking(session, game);
+        freeSlot(session, game);
+        return 0;
+    }
+    place(session, game, &r, result.row, result.col);
+    if (!startComputer(session, game)) {
+        stopThinking(session, game);
+        finishTurn(session, game, &r);
+    }
+    return endReply(&r);
+}
+
+void sessionDropOwner(Session *session, int owner) {
+    for (int i = 0; i < session->maxGames; i++) {
+        SessionGame *game = &session->games[i];
+        if (game->id != 0 && game->owner == owner) closeGame(session, game);
+    }
+}
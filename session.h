@@ -0,0 +1,86 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stddef.h>
+#include "board.h"
+#include "computer.h"
+#include "gamelog.h"
+#include "game.h"
+
+// Many independent games in one process, driven by text commands. Every
+// game has its own size, mode, win length and player names, as in the
+// interactive front ends; seats named "Computer" (and seat O in mode 2) are
+// played by the computer. All game state lives in a pool allocated up front -
+// starting or finishing a game never allocates. The session does no I/O
+// itself: server.c feeds it lines from its clients.
+//
+// Commands are answered at once and never search. A computer move is
+// searched on a pool of worker threads; the game waits meanwhile (MOVE on it
+// is refused) and the rest of its reply comes from sessionResult when the
+// move is found. So replies about one game can arrive after replies to later
+// commands about other games - every line names its game.
+// Part of the game core (gamecore.h).
+//
+// Protocol - one command per line, rows and columns 1-based:
+//   NEW SIZE MODE NAMES [WIN]  Start a game; NAMES as for --names ("Alice,Bob")
+//                              -> GAME id size mode, then (as they are found)
+//                                 the opening moves of any computer seats, then
+//                                 the state line
+//   MOVE id ROW COL            Play for the human whose turn it is
+//                              -> MOVED id symbol row col (the move, then
+//                                 each computer reply as it is found), then
+//                                 the state line
+//   SHOW id                    -> BOARD id size cells ('.' = empty, row by row), then the state line
+//   QUIT id                    -> CLOSED id
+//   STATS                      -> STATS open played moves
+// State line: TURN id symbol | WIN id symbol name | DRAW id. A finished game
+// is closed at once (and logged); errors answer ERR message.
+
+#define SESSION_LINE_MAX 256    // Longest command line
+#define SESSION_MOVE_LINE_MAX 40  // "MOVED id symbol row col\n" with the longest id
+// Most output one command can cause, counting the computer moves that follow
+// it: NEW in an all-computer game leads to the GAME line, a MOVED line for
+// every cell, then the state line (256 bytes covers those and every other
+// single-line reply). Each sessionCommand or sessionResult reply fits too.
+#define SESSION_REPLY_MAX (BOARD_MAX_CELLS * SESSION_MOVE_LINE_MAX + 256)
+
+typedef struct Session Session;
+
+// Pool of maxGames games for clients (owners) 0 to maxOwners - 1. workers
+// threads search the computer moves, each with its own player set up from
+// computer (keep its searches single-threaded); log (may be NULL) receives
+// every finished game. Everything else is called from one thread. Returns
+// NULL if out of memory or a thread cannot be started.
+Session *sessionCreate(int maxGames, int maxOwners, int workers, const ComputerSettings *computer, GameLog *log);
+void sessionDestroy(Session *session);
+
+// Run one command from client owner and write the reply lines to out (at
+// least SESSION_REPLY_MAX bytes). Games belong to the client that started
+// them. Returns the reply length.
+size_t sessionCommand(Session *session, int owner, const char *line, char *out);
+
+// Take the next computer move found by the workers: plays it and writes the
+// rest of the game's reply (MOVED, then the state line once a human is to
+// move or the game is over) to out (SESSION_REPLY_MAX bytes) for *owner.
+// Returns the length - 0 with *owner set if the game was closed meanwhile -
+// or 0 with *owner = -1 when no move is waiting. Never blocks.
+size_t sessionResult(Session *session, int *owner, char *out);
+
+// Games of owner waiting for a computer move. Each can still produce up to
+// SESSION_REPLY_MAX bytes of replies through sessionResult.
+int sessionPending(const Session *session, int owner);
+
+// Readable while moves are waiting for sessionResult (for poll/epoll; -1 on
+// Windows). Take every waiting move to clear it.
+int sessionNotifyFd(const Session *session);
+
+// Block until a move is waiting for sessionResult - only while some game is pending
+void sessionWait(Session *session);
+
+// Close every game of owner (its connection went away)
+void sessionDropOwner(Session *session, int owner);
+
+// Games in progress
+int sessionOpenGames(const Session *session);
+
+#endif
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "simulate.h"
+#include "timer.h"
+
+#define SIM_CHUNK 64  // Games a worker claims at a time
+
+// Everything one worker thread owns - nothing in here is shared
+typedef struct {
+    const SimConfig *cfg;
+    atomic_llong *nextGame;  // Next unclaimed game number (the only shared counter)
+    ComputerPlayer agents[BOARD_MAX_PLAYERS];
+    Board board;             // Reused for every game this worker plays
+    GameLog *log;            // Shared log (NULL = none) - one locked call per game
+    GameRecord record;       // Moves of the current game, for the log
+    SimStats stats;          // Merged into the total after all workers finish
+} SimWorker;
+
+void simDefaults(SimConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->games = 1000;
+    cfg->size = 3;
+    cfg->mode = 1;
+    cfg->players = 2;
+    cfg->seed = 1;
+    cfg->threads = aiDefaultThreads();
+
+    for (int i = 0; i < BOARD_MAX_PLAYERS; i++) {
+        ComputerSettings *agent = &cfg->agents[i];
+        computerDefaults(agent);
+        agent->engine = ENGINE_RANDOM;
+        agent->threads = 1;
+        agent->timeLimit = 0;  // Fixed budgets keep runs fast and repeatable
+        agent->maxDepth = SIM_DEFAULT_DEPTH;
+        agent->playouts = SIM_DEFAULT_PLAYOUTS;
+        agent->ttBits = 16;
+        agent->mctsNodes = 1 << 17;
+        agent->bookPath = NULL;  // Self-play measures the engines, not the book
+    }
+
+    gameLogDefaults(&cfg->log);
+    cfg->log.flush = LOG_FLUSH_FULL;  // Batch as much as possible
+    cfg->log.background = 1;
+}
+
+int simParsePlayers(const char *list, SimConfig *cfg) {
+    char name[32];
+    int count = 0;
+
+    while (*list != '\0' && count < BOARD_MAX_PLAYERS) {
+        size_t len = strcspn(list, ",");
+        if (len == 0 || len >= sizeof(name)) return 0;
+        memcpy(name, list, len);
+        name[len] = '\0';
+        if (!parseEngine(name, &cfg->agents[count].engine)) return 0;
+        count++;
+        list += len;
+        if (*list == ',') list++;
+    }
+    return (*list == '\0') ? count : 0;
+}
+
+// Play game number g; returns the winning seat or -1 for a draw
+static int playGame(SimWorker *w, long long g, int *moves) {
+    const SimConfig *cfg = w->cfg;
+    Board *board = &w->board;
+    boardInitRule(board, cfg->size, cfg->players, w->record.winLength);
+
+    // Every seat gets its own random stream for this game
+    for (int i = 0; i < cfg->players; i++) {
+        computerNewGame(&w->agents[i]);
+        computerSeed(&w->agents[i], rngStreamSeed(cfg->seed, (uint64_t)g * BOARD_MAX_PLAYERS + i));
+    }
+
+    int turn = 0;
+    while (1) {
+        int player = turn % cfg->players;
+        int row, col;
+        computerMove(&w->agents[player], board, player, &row, &col);
+        boardPlace(board, row, col, player);
+        w->record.moves[turn] = (unsigned char)(row * cfg->size + col);
+        turn++;
+
+        if (board->winner >= 0 || boardIsDraw(board)) break;
+    }
+    *moves = turn;
+    if (w->log != NULL) {
+        w->record.number = (unsigned int)g;
+        w->record.moveCount = turn;
+        w->record.winner = board->winner;
+        gameLogGame(w->log, &w->record);
+    }
+    return board->winner;
+}
+
+static void *simWorker(void *arg) {
+    SimWorker *w = (SimWorker *)arg;
+    long long games = w->cfg->games;
+
+    while (1) {
+        long long first = atomic_fetch_add(w->nextGame, SIM_CHUNK);
+        if (first >= games) break;
+        long long last = (first + SIM_CHUNK < games) ? first + SIM_CHUNK : games;
+
+        for (long long g = first; g < last; g++) {
+            int moves;
+            int winner = playGame(w, g, &moves);
+            if (winner >= 0) w->stats.wins[winner]++;
+            else w->stats.draws++;
+
+            w->stats.games++;
+            w->stats.totalMoves += moves;
+            if (moves < w->stats.shortestGame) w->stats.shortestGame = moves;
+            if (moves > w->stats.longestGame) w->stats.longestGame = moves;
+        }
+    }
+    return NULL;
+}
+
+static void freeWorkers(SimWorker *workers, int count, int players) {
+    for (int t = 0; t < count; t++) {
+        for (int i = 0; i < players; i++) computerFree(&workers[t].agents[i]);
+    }
+    free(workers);
+}
+
+int runSimulation(const SimConfig *cfg, SimStats *stats) {
+    int threadCount = cfg->threads < 1 ? 1 : cfg->threads;
+    if (threadCount > AI_MAX_THREADS) threadCount = AI_MAX_THREADS;
+    memset(stats, 0, sizeof(*stats));
+    stats->shortestGame = BOARD_MAX_CELLS + 1;
+
+    SimWorker *workers = (SimWorker *)calloc((size_t)threadCount, sizeof(SimWorker));
+    if (workers == NULL) return 0;
+
+    GameLog *log = NULL;
+    if (cfg->logPath != NULL) {
+        log = gameLogOpen(cfg->logPath, 1, &cfg->log);
+        if (log == NULL) {
+            free(workers);
+            return 0;
+        }
+    }
+
+    atomic_llong nextGame;
+    atomic_init(&nextGame, 0);
+    for (int t = 0; t < threadCount; t++) {
+        SimWorker *w = &workers[t];
+        w->cfg = cfg;
+        w->nextGame = &nextGame;
+        w->log = log;
+        w->record.size = cfg->size;
+        w->record.winLength = cfg->winLength > 0 ? cfg->winLength : cfg->size;
+        w->record.mode = cfg->mode;
+        w->record.players = cfg->players;
+        w->record.seed = cfg->seed;
+        w->stats.shortestGame = BOARD_MAX_CELLS + 1;
+        for (int i = 0; i < cfg->players; i++) {
+            w->record.names[i] = engineName(cfg->agents[i].engine);
+            if (!computerInit(&w->agents[i], &cfg->agents[i])) {
+                freeWorkers(workers, t + 1, cfg->players);
+                gameLogClose(log);
+                return 0;
+            }
+        }
+    }
+
+    // Worker 0 runs on this thread
+    double start = nowSeconds();
+    pthread_t threads[AI_MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threadCount; t++) {
+        if (pthread_create(&threads[started], NULL, simWorker, &workers[t]) != 0) break;
+        started++;
+    }
+    simWorker(&workers[0]);
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    stats->threads = started + 1;
+    gameLogClose(log);  // Timed too: the run is not done until the log is written
+    stats->seconds = nowSeconds() - start;
+
+    // Merge the per-worker results - sums, minimum and maximum do not depend on
+    // which worker played which game
+    for (int t = 0; t < threadCount; t++) {
+        const SimStats *ws = &workers[t].stats;
+        stats->games += ws->games;
+        stats->draws += ws->draws;
+        stats->totalMoves += ws->totalMoves;
+        for (int i = 0; i < BOARD_MAX_PLAYERS; i++) stats->wins[i] += ws->wins[i];
+        if (ws->games > 0 && ws->shortestGame < stats->shortestGame) stats->shortestGame = ws->shortestGame;
+        if (ws->longestGame > stats->longestGame) stats->longestGame = ws->longestGame;
+    }
+
+    freeWorkers(workers, threadCount, cfg->players);
+    return 1;
+}
+
+void printSimStats(FILE *out, const SimConfig *cfg, const SimStats *stats) {
+    double games = stats->games > 0 ? (double)stats->games : 1;
+
+    fprintf(out, "Simulated %lld games on %d x %d (mode %d, seed %u, %d threads)\n",
+            stats->games, cfg->size, cfg->size, cfg->mode, cfg->seed, stats->threads);
+    if (cfg->winLength > 0 && cfg->winLength < cfg->size) fprintf(out, "  Rule:            %d in a row\n", cfg->winLength);
+    for (int i = 0; i < cfg->players; i++) {
+        fprintf(out, "  %c (%-7s) wins: %10lld  (%5.1f%%)\n", playerToSymbol(i),
+                engineName(cfg->agents[i].engine), stats->wins[i], 100.0 * stats->wins[i] / games);
+    }
+    fprintf(out, "  Draws:           %10lld  (%5.1f%%)\n", stats->draws, 100.0 * stats->draws / games);
+    fprintf(out, "  Moves per game:  %.2f average, %d shortest, %d longest\n",
+            stats->totalMoves / games, stats->games ? stats->shortestGame : 0, stats->longestGame);
+    fprintf(out, "  Time:            %.3f s (%.0f games/sec)\n", stats->seconds,
+            stats->seconds > 0 ? stats->games / stats->seconds : 0);
+}
@@ -0,0 +1,59 @@
+#ifndef SIMULATE_H
+#define SIMULATE_H
+
+#include <stdio.h>
+#include "board.h"
+#include "computer.h"
+#include "gamelog.h"
+
+// Headless self-play: plays whole games between computer agents with no
+// terminal I/O and collects summary statistics. Games are spread over
+// worker threads (link with -pthread); every game draws its random numbers
+// from its own stream derived from (seed, game number), so a fixed seed
+// gives the same statistics whatever the number of threads.
+
+#define SIM_DEFAULT_DEPTH 3        // Minimax depth per move in simulations
+#define SIM_DEFAULT_PLAYOUTS 1000  // MCTS playouts per move in simulations
+
+typedef struct {
+    long long games;      // Games to play
+    int size;             // Board size (3 to 10)
+    int winLength;        // Marks in a row that win (0 = the full line)
+    int mode;             // Game mode as in the menu (1, 2 or 3)
+    int players;          // 2, or 3 for mode 3
+    ComputerSettings agents[BOARD_MAX_PLAYERS];  // Who plays each seat (X, O, Z)
+    unsigned int seed;    // Random seed for the whole run
+    int threads;          // Worker threads playing games side by side
+    const char *logPath;  // Record every game here (NULL = no log). With several
+                          // threads the games appear in the order they finish.
+    GameLogSettings log;
+} SimConfig;
+
+typedef struct {
+    long long games;
+    long long wins[BOARD_MAX_PLAYERS];  // Wins per seat
+    long long draws;
+    long long totalMoves;
+    int shortestGame;
+    int longestGame;
+    int threads;  // Workers actually run (cfg->threads clamped to 1..AI_MAX_THREADS)
+    double seconds;
+} SimStats;
+
+// Simulation defaults: 1000 random-vs-random games on 3 x 3, one worker per
+// core, no log (a log flushes only when its buffer is full, from a writer
+// thread). Search agents are single-threaded with fixed depth/playout budgets
+// and no time limit, so results only depend on the seed.
+void simDefaults(SimConfig *cfg);
+
+// Parse a seat list such as "random,random,ai" into cfg->agents.
+// Returns the number of seats read, or 0 on an unknown agent name.
+int simParsePlayers(const char *list, SimConfig *cfg);
+
+// Play cfg->games games; returns 0 if an agent or the log could not be created
+int runSimulation(const SimConfig *cfg, SimStats *stats);
+
+// Human-readable summary of a finished run
+void printSimStats(FILE *out, const SimConfig *cfg, const SimStats *stats);
+
+#endif
@@ -0,0 +1,53 @@
+#!/bin/sh
+# End-to-end checks run by make check (BIN = the build directory):
+#   - self-play logs in text and binary, both win rules and 2 and 3 players,
+#     each re-checked move by move with replay --verify
+#   - loadtest against a live server, in both modes, then replay --verify
+#     over the games the server logged
+# Exits non-zero on the first failure.
+
+set -e
+BIN=${1:-build}
+WORK=$(mktemp -d)
+SERVER=
+trap '[ -n "$SERVER" ] && kill $SERVER 2>/dev/null; rm -rf "$WORK"' EXIT
+
+# replay --verify over a log; a log with no games in it fails too
+verify() {
+    out=$("$BIN/replay" "$1" --verify --threads 2) || { echo "$out"; exit 1; }
+    echo "$out"
+    case $out in
+        "Checked 0 games"*) echo "No games in $1."; exit 1 ;;
+    esac
+}
+
+echo "Self-play logs:"
+"$BIN/multigrids" --simulate 200 --size 5 --seed 7 --players ai,random --depth 2 --book none \
+    --log "$WORK/full.txt" > /dev/null
+verify "$WORK/full.txt"
+"$BIN/multigrids" --simulate 200 --mode 3 --size 7 --win-length 4 --seed 7 --players random,ai,mcts --depth 2 \
+    --playouts 200 --book none --log "$WORK/row.bin" --log-format binary > /dev/null
+verify "$WORK/row.bin"
+
+echo "Server under load:"
+"$BIN/server" --socket "$WORK/server.sock" --games 256 --clients 8 --workers 2 --depth 2 --book none \
+    --log "$WORK/server.bin" --log-format binary > "$WORK/server.out" 2>&1 &
+SERVER=$!
+tries=0
+while [ ! -S "$WORK/server.sock" ]; do
+    tries=$((tries + 1))
+    if [ $tries -gt 50 ] || ! kill -0 $SERVER 2>/dev/null; then
+        echo "  server did not start:"
+        cat "$WORK/server.out"
+        exit 1
+    fi
+    sleep 0.1
+done
+"$BIN/loadtest" --socket "$WORK/server.sock" --clients 4 --games 16 --size 4 --mode 1 --seconds 1
+"$BIN/loadtest" --socket "$WORK/server.sock" --clients 4 --games 16 --size 3 --mode 2 --seconds 1
+kill $SERVER
+wait $SERVER
+SERVER=
+verify "$WORK/server.bin"
+
+echo "All checks passed."
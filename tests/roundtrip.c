@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include "board.h"
+#include "record.h"
+
+// Round-trip checks over random games on every size, both win rules and 2
+// and 3 players: unmaking each move restores the Board byte for byte and
+// redo plays the same positions again, and a game encoded as a binary
+// record decodes to the same game, passes recordCheck and reads back from
+// a version 1 record as a full-line game. Run by make check.
+
+#define ROUNDTRIP_GAMES 20000
+
+static int failures = 0;
+
+static void fail(int game, const char *what) {
+    if (failures++ < 10) printf("Game %d: %s\n", game, what);
+}
+
+// Play a random game in state, keeping the Board after every move in history
+static void playRandom(GameState *state, Rng *rng, Board history[BOARD_MAX_CELLS + 1]) {
+    history[0] = state->board;
+    while (state->board.winner < 0 && !boardIsFull(&state->board)) {
+        int row, col;
+        boardRandomMove(&state->board, rng, &row, &col);
+        gameStateMake(state, row, col);
+        history[state->board.moveCount] = state->board;
+    }
+}
+
+static void checkUnmake(int game, GameState *state, Board history[BOARD_MAX_CELLS + 1]) {
+    int moves = state->board.moveCount;
+    while (gameStateUnmake(state)) {
+        if (memcmp(&state->board, &history[state->board.moveCount], sizeof(Board)) != 0) {
+            fail(game, "unmake does not restore the board");
+            return;
+        }
+    }
+    while (gameStateRedo(state)) {
+        if (memcmp(&state->board, &history[state->board.moveCount], sizeof(Board)) != 0) {
+            fail(game, "redo does not give the same board");
+            return;
+        }
+    }
+    if (state->board.moveCount != moves) fail(game, "redo stops short");
+}
+
+static void checkRecord(int game, const GameState *state, unsigned int seed) {
+    const Board *board = &state->board;
+    GameRecord record = {0};
+    record.size = board->size;
+    record.winLength = board->winLength;
+    record.mode = (board->players > 2) ? 3 : 1;
+    record.players = board->players;
+    record.seed = seed;
+    record.number = (unsigned int)game;
+    record.moveCount = board->moveCount;
+    memcpy(record.moves, state->moves, (size_t)board->moveCount);
+    record.winner = board->winner;
+
+    unsigned char data[RECORD_MAX_BYTES];
+    size_t used = recordEncode(&record, data);
+    GameRecord decoded;
+    if (recordDecode(data, used, RECORD_VERSION, &decoded) != (long)used || decoded.size != record.size ||
+        decoded.winLength != record.winLength || decoded.mode != record.mode ||
+        decoded.players != record.players || decoded.seed != record.seed || decoded.number != record.number ||
+        decoded.moveCount != record.moveCount || decoded.winner != record.winner ||
+        memcmp(decoded.moves, record.moves, (size_t)record.moveCount) != 0) {
+        fail(game, "record does not decode to the same game");
+        return;
+    }
+    if (recordDecode(data, used - 1, RECORD_VERSION, &decoded) != 0) fail(game, "truncated record accepted");
+    if (recordCheck(&record, NULL) != REPLAY_OK) fail(game, "recordCheck rejects a played game");
+
+    // Version 1 kept the win-length byte reserved: always a full line
+    data[5] = 0;
+    if (recordDecode(data, used, 1, &decoded) != (long)used || decoded.winLength != record.size) {
+        fail(game, "version 1 record is not a full-line game");
+    }
+}
+
+int main(void) {
+    Rng rng;
+    rngSeed(&rng, 5);
+
+    for (int game = 0; game < ROUNDTRIP_GAMES; game++) {
+        int size = BOARD_MIN_SIZE + (int)rngBelow(&rng, BOARD_MAX_SIZE - BOARD_MIN_SIZE + 1);
+        int players = 2 + (int)rngBelow(&rng, 2);
+        int winLength = rngBelow(&rng, 2) ? size : BOARD_MIN_SIZE + (int)rngBelow(&rng, size - BOARD_MIN_SIZE + 1);
+
+        static GameState state;
+        static Board history[BOARD_MAX_CELLS + 1];
+        gameStateInit(&state, size, players, winLength);
+        playRandom(&state, &rng, history);
+        checkRecord(game, &state, 5);
+        checkUnmake(game, &state, history);
+    }
+
+    printf("Round trips over %d games: %s\n", ROUNDTRIP_GAMES, failures == 0 ? "ok" : "FAILED");
+    return failures > 0;
+}
@@ -0,0 +1,257 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "think.h"
+#include "timer.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+struct Thinker {
+    ComputerPlayer *cp;
+    double aiTime, mctsTime;  // cp's own time limits (pondering runs without one)
+    atomic_int stop;          // The engines' AiLimits.stop / MctsLimits.stop
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;   // Signalled on every change below
+
+    // Under lock
+    int quit;
+    int pending;              // Job waiting for the thread
+    int busy;                 // Thread searching
+    int finished;             // The job's move is in row, col
+    int pondering;            // The job is a ponder search (not yet hit)
+    Board board;              // The job
+    int player;
+    double started;           // When the job was handed over
+    double deadline;          // Enforced by thinkWait (0 = the engine keeps its own time)
+    int row, col;
+
+#ifndef _WIN32
+    int wake[2];              // Pipe written when a job ends, so poll() sees it
+#endif
+};
+
+static void *thinkThread(void *arg) {
+    Thinker *t = (Thinker *)arg;
+    pthread_mutex_lock(&t->lock);
+    for (;;) {
+        while (!t->pending && !t->quit) pthread_cond_wait(&t->changed, &t->lock);
+        if (t->quit) break;
+        Board board = t->board;
+        int player = t->player;
+        int ponder = t->pondering;
+        t->pending = 0;
+        t->busy = 1;
+        pthread_mutex_unlock(&t->lock);
+
+        // Pondering has no time limit of its own: on a hit thinkWait applies it
+        t->cp->aiLimits.timeLimit = ponder ? 0 : t->aiTime;
+        t->cp->mctsLimits.timeLimit = ponder ? 0 : t->mctsTime;
+        int row, col;
+        computerMove(t->cp, &board, player, &row, &col);
+
+        pthread_mutex_lock(&t->lock);
+        t->busy = 0;
+        t->finished = 1;
+        t->row = row;
+        t->col = col;
+        pthread_cond_broadcast(&t->changed);
+#ifndef _WIN32
+        char byte = 1;
+        if (write(t->wake[1], &byte, 1) < 0) {}  // Pipe full: a wake-up is already waiting
+#endif
+    }
+    pthread_mutex_unlock(&t->lock);
+    return NULL;
+}
+
+Thinker *thinkCreate(ComputerPlayer *cp) {
+    Thinker *t = (Thinker *)calloc(1, sizeof(Thinker));
+    if (t == NULL) return NULL;
+    t->cp = cp;
+    t->aiTime = cp->aiLimits.timeLimit;
+    t->mctsTime = cp->mctsLimits.timeLimit;
+    atomic_init(&t->stop, 0);
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->changed, NULL);
+#ifndef _WIN32
+    if (pipe(t->wake) != 0) {
+        pthread_cond_destroy(&t->changed);
+        pthread_mutex_destroy(&t->lock);
+        free(t);
+        return NULL;
+    }
+    for (int i = 0; i < 2; i++) fcntl(t->wake[i], F_SETFL, fcntl(t->wake[i], F_GETFL) | O_NONBLOCK);
+#endif
+    if (pthread_create(&t->thread, NULL, thinkThread, t) != 0) {
+#ifndef _WIN32
+        close(t->wake[0]);
+        close(t->wake[1]);
+#endif
+        pthread_cond_destroy(&t->changed);
+        pthread_mutex_destroy(&t->lock);
+        free(t);
+        return NULL;
+    }
+    cp->aiLimits.stop = &t->stop;
+    cp->mctsLimits.stop = &t->stop;
+    return t;
+}
+
+void thinkDestroy(Thinker *t) {
+    if (t == NULL) return;
+    thinkCancel(t);
+    pthread_mutex_lock(&t->lock);
+    t->quit = 1;
+    pthread_cond_broadcast(&t->changed);
+    pthread_mutex_unlock(&t->lock);
+    pthread_join(t->thread, NULL);
+
+    // The player goes back to searching on the caller's thread
+    t->cp->aiLimits.timeLimit = t->aiTime;
+    t->cp->mctsLimits.timeLimit = t->mctsTime;
+    t->cp->aiLimits.stop = NULL;
+    t->cp->mctsLimits.stop = NULL;
+#ifndef _WIN32
+    close(t->wake[0]);
+    close(t->wake[1]);
+#endif
+    pthread_cond_destroy(&t->changed);
+    pthread_mutex_destroy(&t->lock);
+    free(t);
+}
+
+void thinkCancel(Thinker *t) {
+    pthread_mutex_lock(&t->lock);
+    t->pending = 0;
+    if (t->busy) atomic_store(&t->stop, 1);
+    while (t->busy) pthread_cond_wait(&t->changed, &t->lock);
+    t->finished = 0;
+    t->pondering = 0;
+    t->deadline = 0;
+    pthread_mutex_unlock(&t->lock);
+}
+
+// Hand a job to the idle thread
+static void begin(Thinker *t, const Board *board, int player, int ponder) {
+    thinkCancel(t);
+    pthread_mutex_lock(&t->lock);
+    t->board = *board;
+    t->player = player;
+    t->pondering = ponder;
+    t->started = nowSeconds();
+    atomic_store(&t->stop, 0);
+    t->pending = 1;
+    pthread_cond_broadcast(&t->changed);
+    pthread_mutex_unlock(&t->lock);
+}
+
+void thinkStart(Thinker *t, const Board *board, int player) {
+    begin(t, board, player, 0);
+}
+
+int thinkPonder(Thinker *t, const Board *board, int player) {
+    if (t->cp->engine != ENGINE_MINIMAX) return 0;  // MCTS has no time-free mode; random needs none
+    begin(t, board, player, 1);
+    return 1;
+}
+
+static int samePosition(const Board *a, const Board *b) {
+    return a->size == b->size && a->moveCount == b->moveCount && a->hash == b->hash &&
+           memcmp(a->marks, b->marks, sizeof(a->marks)) == 0;
+}
+
+int thinkPonderHit(Thinker *t, const Board *board, int player) {
+    pthread_mutex_lock(&t->lock);
+    int hit = t->pondering && t->player == player && samePosition(&t->board, board);
+    if (hit) {
+        t->pondering = 0;
+        if (t->aiTime > 0) t->deadline = t->started + t->aiTime;
+    }
+    pthread_mutex_unlock(&t->lock);
+    if (!hit) thinkCancel(t);
+    return hit;
+}
+
+void thinkStop(Thinker *t) {
+    atomic_store(&t->stop, 1);
+}
+
+int thinkInputIsInteractive(void) {
+#ifdef _WIN32
+    return 0;
+#else
+    return isatty(STDIN_FILENO);
+#endif
+}
+
+// 1 if the move is ready; otherwise *deadline is the time to stop the search (0 = none)
+static int isReady(Thinker *t, double *deadline) {
+    pthread_mutex_lock(&t->lock);
+    int ready = t->finished && !t->pending;
+    *deadline = t->deadline;
+    pthread_mutex_unlock(&t->lock);
+    return ready;
+}
+
+ThinkEvent thinkWait(Thinker *t, int watchInput) {
+#ifndef _WIN32
+    double deadline;
+    int input = watchInput && thinkInputIsInteractive();
+    while (!isReady(t, &deadline)) {
+        int timeout = -1;
+        if (deadline > 0) {
+            double left = deadline - nowSeconds();
+            if (left <= 0) {
+                thinkStop(t);
+                pthread_mutex_lock(&t->lock);
+                t->deadline = 0;
+                pthread_mutex_unlock(&t->lock);
+                continue;
+            }
+            timeout = (int)(left * 1000) + 1;
+        }
+        struct pollfd fds[2] = { { t->wake[0], POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+        if (poll(fds, input ? 2 : 1, timeout) <= 0) continue;
+        char bytes[16];
+        if (fds[0].revents & POLLIN) {
+            while (read(t->wake[0], bytes, sizeof(bytes)) > 0) {}
+        }
+        if (input && (fds[1].revents & (POLLIN | POLLHUP)) && !isReady(t, &deadline)) return THINK_INPUT;
+    }
+#else
+    (void)watchInput;
+    pthread_mutex_lock(&t->lock);
+    while (!(t->finished && !t->pending)) {
+        if (t->deadline > 0 && nowSeconds() >= t->deadline) {
+            thinkStop(t);
+            t->deadline = 0;
+        }
+        if (t->deadline > 0) {
+            struct timespec until;
+            timespec_get(&until, TIME_UTC);
+            double left = t->deadline - nowSeconds() + until.tv_nsec * 1e-9;
+            until.tv_sec += (time_t)left;
+            until.tv_nsec = (long)((left - (double)(time_t)left) * 1e9);
+            pthread_cond_timedwait(&t->changed, &t->lock, &until);
+        } else {
+            pthread_cond_wait(&t->changed, &t->lock);
+        }
+    }
+    pthread_mutex_unlock(&t->lock);
+#endif
+    return THINK_DONE;
+}
+
+void thinkResult(Thinker *t, int *row, int *col) {
+    pthread_mutex_lock(&t->lock);
+    *row = t->row;
+    *col = t->col;
+    t->finished = 0;
+    pthread_mutex_unlock(&t->lock);
+}
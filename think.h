@@ -0,0 +1,63 @@
+#ifndef THINK_H
+#define THINK_H
+
+#include "board.h"
+#include "computer.h"
+
+// Runs a computer player's searches on a background thread, so the game
+// loop stays free while the computer thinks: it can wait for the move, read
+// the player's commands meanwhile, end the search early with the best move
+// found so far ("move now") or drop it (undo). After its own move the
+// computer can also ponder: search the position after the reply it expects
+// while the human thinks. If the human plays that reply the running search
+// simply carries on as the real one, with its time counted from when
+// pondering began - often the move is ready at once. A different reply
+// drops the pondering; the work stays in the transposition table.
+// Part of the game core; uses pthreads (and poll() for input on POSIX).
+
+typedef enum {
+    THINK_DONE,   // The move is ready (thinkResult)
+    THINK_INPUT   // A line of input is waiting on stdin
+} ThinkEvent;
+
+typedef struct Thinker Thinker;
+
+// Start the background thread for cp; cp belongs to the thinker until
+// thinkDestroy. Returns NULL if the thread cannot be started.
+Thinker *thinkCreate(ComputerPlayer *cp);
+void thinkDestroy(Thinker *thinker);
+
+// Begin choosing a move for player on board (copied), within cp's limits.
+// Anything still running is dropped first.
+void thinkStart(Thinker *thinker, const Board *board, int player);
+
+// Begin pondering: board is the position after the expected reply, player
+// the seat to move there. Only the minimax engine ponders; returns 0 (and
+// does nothing) otherwise.
+int thinkPonder(Thinker *thinker, const Board *board, int player);
+
+// The human has moved and it is player's turn on board: if that is the
+// position being pondered, the pondering search becomes the real one and 1
+// is returned. Otherwise pondering (if any) is dropped and 0 is returned -
+// call thinkStart.
+int thinkPonderHit(Thinker *thinker, const Board *board, int player);
+
+// Wait until the move is ready or - with watchInput, when stdin is a
+// terminal - until the player types a line. Ends the search when its time
+// is up.
+ThinkEvent thinkWait(Thinker *thinker, int watchInput);
+
+// Finish the search now with the best move found so far (thinkWait then
+// returns THINK_DONE promptly)
+void thinkStop(Thinker *thinker);
+
+// Drop the search or pondering in progress and wait until the thread is idle
+void thinkCancel(Thinker *thinker);
+
+// The move after THINK_DONE; cp->report and cp->replyRow/replyCol describe it
+void thinkResult(Thinker *thinker, int *row, int *col);
+
+// 1 if thinkWait can watch for input: stdin is a terminal (POSIX only)
+int thinkInputIsInteractive(void);
+
+#endif
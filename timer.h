@@ -0,0 +1,25 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+// Monotonic wall-clock time in seconds, used for search budgets and benchmarks
+
+#ifdef _WIN32
+#include <windows.h>
+
+static inline double nowSeconds(void) {
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+}
+#else
+#include <time.h>
+
+static inline double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+#endif
+
+#endif